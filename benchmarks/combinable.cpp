@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include <combinable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#ifdef CONCURRENT_BENCHMARK_TBB
+#include <tbb/combinable.h>
+#endif
+#if defined(_MSC_VER) && __has_include(<ppl.h>)
+#define CONCURRENT_BENCHMARK_CONCRT
+#include <ppl.h>
+#endif
+
+namespace {
+
+    // Contended baselines for what combinable is meant to replace
+    template < class Type >
+    class Atomic_counter {
+      public:
+        std::atomic< Type > &local() { return mValue; }
+
+      private:
+        std::atomic< Type > mValue { 0 };
+    };
+
+    constexpr int Max_threads = 64;
+
+    template < class Combinable >
+    void BM_combinable_local(benchmark::State &state) {
+        static Combinable *combinable = nullptr;
+        if (state.thread_index() == 0) {
+            combinable = new Combinable {};
+        }
+
+        for (auto _ : state) {
+            ++combinable->local();
+        }
+        state.SetItemsProcessed(state.iterations());
+
+        if (state.thread_index() == 0) {
+            delete combinable;
+        }
+    }
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_combinable_local, concurrent::combinable< std::int64_t >)
+    ->ThreadRange(1, Max_threads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_combinable_local, Atomic_counter< std::int64_t >)->ThreadRange(1, Max_threads)->UseRealTime();
+#ifdef CONCURRENT_BENCHMARK_TBB
+BENCHMARK_TEMPLATE(BM_combinable_local, tbb::combinable< std::int64_t >)->ThreadRange(1, Max_threads)->UseRealTime();
+#endif
+#ifdef CONCURRENT_BENCHMARK_CONCRT
+BENCHMARK_TEMPLATE(BM_combinable_local, Concurrency::combinable< std::int64_t >)
+    ->ThreadRange(1, Max_threads)
+    ->UseRealTime();
+#endif
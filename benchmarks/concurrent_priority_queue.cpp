@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include <concurrent_priority_queue.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <queue>
+
+#ifdef CONCURRENT_BENCHMARK_TBB
+#include <tbb/concurrent_priority_queue.h>
+#endif
+#if defined(_MSC_VER) && __has_include(<concurrent_priority_queue.h>)
+#define CONCURRENT_BENCHMARK_CONCRT
+#include <concurrent_priority_queue.h>
+#endif
+
+namespace {
+
+    // The single-lock binary heap flat combining is meant to replace
+    template < class Type >
+    class Mutex_priority_queue {
+      public:
+        void push(const Type &value) {
+            std::scoped_lock guard { mMutex };
+            mQueue.push(value);
+        }
+
+        bool try_pop(Type &dest) {
+            std::scoped_lock guard { mMutex };
+            if (mQueue.empty()) {
+                return false;
+            }
+            dest = mQueue.top();
+            mQueue.pop();
+            return true;
+        }
+
+      private:
+        std::mutex                  mMutex;
+        std::priority_queue< Type > mQueue;
+    };
+
+    constexpr int Max_threads = 64;
+
+    // Every thread alternates pushes and pops around a pre-filled heap, like a scheduler's ready queue
+    template < class Queue >
+    void BM_priority_queue_push_pop(benchmark::State &state) {
+        static Queue *queue = nullptr;
+        if (state.thread_index() == 0) {
+            queue = new Queue {};
+            for (std::uint64_t i = 0; i < 4096; ++i) {
+                queue->push(i * 2654435761u % 65536);
+            }
+        }
+
+        std::uint64_t key   = static_cast< std::uint64_t >(state.thread_index());
+        std::uint64_t value = 0;
+        for (auto _ : state) {
+            key = key * 6364136223846793005u + 1442695040888963407u;
+            queue->push(key >> 48);
+            benchmark::DoNotOptimize(queue->try_pop(value));
+        }
+        state.SetItemsProcessed(state.iterations() * 2);
+
+        if (state.thread_index() == 0) {
+            delete queue;
+        }
+    }
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_priority_queue_push_pop, concurrent::concurrent_priority_queue< std::uint64_t >)
+    ->ThreadRange(1, Max_threads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_priority_queue_push_pop, Mutex_priority_queue< std::uint64_t >)
+    ->ThreadRange(1, Max_threads)
+    ->UseRealTime();
+#ifdef CONCURRENT_BENCHMARK_TBB
+BENCHMARK_TEMPLATE(BM_priority_queue_push_pop, tbb::concurrent_priority_queue< std::uint64_t >)
+    ->ThreadRange(1, Max_threads)
+    ->UseRealTime();
+#endif
+#ifdef CONCURRENT_BENCHMARK_CONCRT
+BENCHMARK_TEMPLATE(BM_priority_queue_push_pop, Concurrency::concurrent_priority_queue< std::uint64_t >)
+    ->ThreadRange(1, Max_threads)
+    ->UseRealTime();
+#endif
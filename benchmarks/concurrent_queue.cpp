@@ -0,0 +1,280 @@
+#include <benchmark/benchmark.h>
+#include <concurrent_queue.hpp>
+#include <sharded_concurrent_queue.hpp>
+#include <spsc_queue.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+#ifdef CONCURRENT_BENCHMARK_TBB
+#include <tbb/concurrent_queue.h>
+#endif
+#ifdef CONCURRENT_BENCHMARK_MOODYCAMEL
+#include <concurrentqueue.h>
+#endif
+#if defined(_MSC_VER) && __has_include(<concurrent_queue.h>)
+#define CONCURRENT_BENCHMARK_CONCRT
+#include <concurrent_queue.h>
+#endif
+
+namespace {
+
+    // Payload sizes straddle the thresholds of the default segment_traits
+    template < std::size_t Size >
+    struct Payload {
+        std::array< unsigned char, Size > mBytes {};
+    };
+
+    // Same size as Payload< 8 >, but its containers start at 4KB segments and double
+    struct Tuned_handle {
+        std::uint64_t mValue {};
+    };
+
+    // Large messages decoded from a buffer: built on the stack and pushed, emplaced, or decoded into a reserved slot.
+    // Default construction leaves the bytes for the decoder to fill
+    struct Large_message {
+        Large_message() noexcept {}
+
+        std::array< unsigned char, 1024 > mBytes;
+    };
+
+    void Decode_into(Large_message &message, const unsigned char *buffer) noexcept {
+        std::copy_n(buffer, message.mBytes.size(), message.mBytes.begin());
+    }
+
+    template < int Mode >
+    void BM_queue_large_message(benchmark::State &state) {
+        concurrent::concurrent_queue< Large_message > queue {};
+        std::array< unsigned char, 1024 >               buffer {};
+        std::optional< Large_message >                  popped {};
+
+        for (auto _ : state) {
+            for (auto i = 0; i < 64; ++i) {
+                buffer[0] = static_cast< unsigned char >(i);
+                if constexpr (Mode == 0) {
+                    Large_message message;
+                    Decode_into(message, buffer.data());
+                    queue.push(std::move(message));
+                } else if constexpr (Mode == 1) {
+                    queue.emplace(); // Not decoded, the cost of the slot alone
+                } else {
+                    auto slot = queue.reserve_slot();
+                    Decode_into(slot.emplace(), buffer.data());
+                    slot.commit();
+                }
+            }
+            for (auto i = 0; i < 64; ++i) {
+                popped = queue.try_pop();
+            }
+            benchmark::DoNotOptimize(popped);
+        }
+        state.SetItemsProcessed(state.iterations() * 64);
+    }
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_queue_large_message, 0)->Name("BM_queue_large_message/push_decoded");
+BENCHMARK_TEMPLATE(BM_queue_large_message, 1)->Name("BM_queue_large_message/emplace");
+BENCHMARK_TEMPLATE(BM_queue_large_message, 2)->Name("BM_queue_large_message/decode_into_reserved_slot");
+
+template <>
+struct concurrent::segment_traits< Tuned_handle > : concurrent::segment_traits_defaults< Tuned_handle > {
+    static constexpr std::size_t initial_segment_bytes = 4096;
+    static constexpr std::size_t growth_numerator      = 2;
+    static constexpr std::size_t growth_denominator    = 1;
+};
+
+namespace {
+
+    template < class Type >
+    class Mutex_queue {
+      public:
+        using value_type = Type;
+
+        void push(const Type &value) {
+            std::scoped_lock guard { mMutex };
+            mQueue.push(value);
+        }
+
+        bool try_pop(Type &dest) {
+            std::scoped_lock guard { mMutex };
+            if (mQueue.empty()) {
+                return false;
+            }
+            dest = std::move(mQueue.front());
+            mQueue.pop();
+            return true;
+        }
+
+      private:
+        std::mutex         mMutex;
+        std::queue< Type > mQueue;
+    };
+
+#ifdef CONCURRENT_BENCHMARK_MOODYCAMEL
+    template < class Type >
+    class Moodycamel_queue {
+      public:
+        using value_type = Type;
+
+        void push(const Type &value) { mQueue.enqueue(value); }
+        bool try_pop(Type &dest) { return mQueue.try_dequeue(dest); }
+
+      private:
+        moodycamel::ConcurrentQueue< Type > mQueue;
+    };
+#endif
+
+    constexpr int Max_threads = 64;
+
+    // Every thread alternates push and try_pop on one shared queue
+    template < class Queue >
+    void BM_queue_push_pop(benchmark::State &state) {
+        static Queue *queue = nullptr;
+        if (state.thread_index() == 0) {
+            queue = new Queue {};
+        }
+
+        typename Queue::value_type value {};
+        for (auto _ : state) {
+            queue->push(value);
+            benchmark::DoNotOptimize(queue->try_pop(value));
+        }
+        state.SetItemsProcessed(state.iterations() * 2);
+
+        if (state.thread_index() == 0) {
+            delete queue;
+        }
+    }
+
+    // state.range(0) percent of the threads only push, the rest only try_pop
+    template < class Queue >
+    void BM_queue_producer_consumer(benchmark::State &state) {
+        static Queue *queue = nullptr;
+        if (state.thread_index() == 0) {
+            queue = new Queue {};
+        }
+
+        const auto   producers = std::max< std::int64_t >(1, state.threads() * state.range(0) / 100);
+        const bool   producer  = state.thread_index() < producers;
+        std::int64_t processed = 0;
+
+        typename Queue::value_type value {};
+        for (auto _ : state) {
+            if (producer) {
+                queue->push(value);
+                ++processed;
+            } else {
+                processed += queue->try_pop(value);
+            }
+        }
+        state.SetItemsProcessed(processed);
+        state.counters["producer"] = producer;
+
+        if (state.thread_index() == 0) {
+            delete queue;
+        }
+    }
+
+    // Thread 0 is the only producer, thread 1 the only consumer
+    template < class Queue >
+    void BM_queue_single_producer_consumer(benchmark::State &state) {
+        static Queue *queue = nullptr;
+        if (state.thread_index() == 0) {
+            queue = new Queue {};
+        }
+
+        std::int64_t               processed = 0;
+        typename Queue::value_type value {};
+        for (auto _ : state) {
+            if (state.thread_index() == 0) {
+                queue->push(value);
+                ++processed;
+            } else {
+                processed += queue->try_pop(value);
+            }
+        }
+        state.SetItemsProcessed(processed);
+
+        if (state.thread_index() == 0) {
+            delete queue;
+        }
+    }
+
+    // Single threaded bursts, so segment allocation and element size dominate
+    template < class Queue >
+    void BM_queue_burst(benchmark::State &state) {
+        Queue      queue {};
+        const auto burst = state.range(0);
+
+        typename Queue::value_type value {};
+        for (auto _ : state) {
+            for (std::int64_t i = 0; i < burst; ++i) {
+                queue.push(value);
+            }
+            for (std::int64_t i = 0; i < burst; ++i) {
+                benchmark::DoNotOptimize(queue.try_pop(value));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * burst * 2);
+        state.SetBytesProcessed(state.iterations() * burst * 2 * sizeof(value));
+    }
+
+    // A fresh queue per burst, so the segment schedule of segment_traits decides the allocation count
+    template < class Queue >
+    void BM_queue_cold_burst(benchmark::State &state) {
+        const auto burst = state.range(0);
+
+        typename Queue::value_type value {};
+        for (auto _ : state) {
+            Queue queue {};
+            for (std::int64_t i = 0; i < burst; ++i) {
+                queue.push(value);
+            }
+            for (std::int64_t i = 0; i < burst; ++i) {
+                benchmark::DoNotOptimize(queue.try_pop(value));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * burst * 2);
+    }
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_queue_cold_burst, concurrent::concurrent_queue< Payload< 8 > >)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_queue_cold_burst, concurrent::concurrent_queue< Tuned_handle >)->Arg(64)->Arg(4096);
+
+BENCHMARK_TEMPLATE(BM_queue_single_producer_consumer, concurrent::spsc_queue< int >)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_queue_single_producer_consumer, concurrent::concurrent_queue< int >)->Threads(2)->UseRealTime();
+
+#define CONCURRENT_QUEUE_BENCHMARKS(queue_type)                                                                   \
+    BENCHMARK_TEMPLATE(BM_queue_push_pop, queue_type< int >)->ThreadRange(1, Max_threads)->UseRealTime();       \
+    BENCHMARK_TEMPLATE(BM_queue_producer_consumer, queue_type< int >)                                           \
+        ->Arg(25)                                                                                               \
+        ->Arg(50)                                                                                               \
+        ->Arg(75)                                                                                               \
+        ->ThreadRange(2, Max_threads)                                                                           \
+        ->UseRealTime();                                                                                        \
+    BENCHMARK_TEMPLATE(BM_queue_burst, queue_type< Payload< 8 > >)->Arg(1024);                                  \
+    BENCHMARK_TEMPLATE(BM_queue_burst, queue_type< Payload< 15 > >)->Arg(1024);                                 \
+    BENCHMARK_TEMPLATE(BM_queue_burst, queue_type< Payload< 16 > >)->Arg(1024);                                 \
+    BENCHMARK_TEMPLATE(BM_queue_burst, queue_type< Payload< 31 > >)->Arg(1024);                                 \
+    BENCHMARK_TEMPLATE(BM_queue_burst, queue_type< Payload< 32 > >)->Arg(1024);                                 \
+    BENCHMARK_TEMPLATE(BM_queue_burst, queue_type< Payload< 64 > >)->Arg(1024)
+
+CONCURRENT_QUEUE_BENCHMARKS(concurrent::concurrent_queue);
+CONCURRENT_QUEUE_BENCHMARKS(concurrent::sharded_concurrent_queue);
+CONCURRENT_QUEUE_BENCHMARKS(Mutex_queue);
+#ifdef CONCURRENT_BENCHMARK_TBB
+CONCURRENT_QUEUE_BENCHMARKS(tbb::concurrent_queue);
+#endif
+#ifdef CONCURRENT_BENCHMARK_MOODYCAMEL
+CONCURRENT_QUEUE_BENCHMARKS(Moodycamel_queue);
+#endif
+#ifdef CONCURRENT_BENCHMARK_CONCRT
+CONCURRENT_QUEUE_BENCHMARKS(Concurrency::concurrent_queue);
+#endif
@@ -0,0 +1,203 @@
+#include <benchmark/benchmark.h>
+#include <concurrent_vector.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef CONCURRENT_BENCHMARK_TBB
+#include <tbb/concurrent_vector.h>
+#endif
+#if defined(_MSC_VER) && __has_include(<concurrent_vector.h>)
+#define CONCURRENT_BENCHMARK_CONCRT
+#include <concurrent_vector.h>
+#endif
+
+namespace {
+
+    template < class Type >
+    class Mutex_vector {
+      public:
+        using value_type = Type;
+
+        void push_back(const Type &value) {
+            std::scoped_lock guard { mMutex };
+            mVector.push_back(value);
+        }
+
+        const Type &operator[](std::size_t index) const { return mVector[index]; }
+
+        auto begin() const { return mVector.begin(); }
+        auto end() const { return mVector.end(); }
+
+      private:
+        std::mutex          mMutex;
+        std::vector< Type > mVector;
+    };
+
+    constexpr int          Max_threads = 64;
+    constexpr std::int64_t Read_size   = 1 << 20;
+    constexpr std::size_t  Index_count = 1 << 12;
+
+    template < class Vector >
+    void BM_vector_push_back(benchmark::State &state) {
+        static Vector *vector = nullptr;
+        if (state.thread_index() == 0) {
+            vector = new Vector {};
+        }
+
+        typename Vector::value_type value {};
+        for (auto _ : state) {
+            vector->push_back(value);
+        }
+        state.SetItemsProcessed(state.iterations());
+
+        if (state.thread_index() == 0) {
+            delete vector;
+        }
+    }
+
+    // Shared by every read benchmark of one vector type, kept alive until exit
+    template < class Vector >
+    const Vector &Filled_vector() {
+        static const auto *vector = []() {
+            auto filled = new Vector {};
+            for (std::int64_t i = 0; i < Read_size; ++i) {
+                filled->push_back(static_cast< typename Vector::value_type >(i));
+            }
+            return filled;
+        }();
+        return *vector;
+    }
+
+    template < class Vector >
+    void BM_vector_random_read(benchmark::State &state) {
+        const auto &vector = Filled_vector< Vector >();
+
+        std::mt19937_64                               engine { static_cast< std::uint64_t >(state.thread_index()) };
+        std::uniform_int_distribution< std::size_t > distribution { 0, Read_size - 1 };
+        std::vector< std::size_t >                    indices(Index_count);
+        for (auto &index : indices) {
+            index = distribution(engine);
+        }
+
+        std::size_t next = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(vector[indices[next++ % Index_count]]);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template < class Vector >
+    void BM_vector_iterate(benchmark::State &state) {
+        const auto &vector = Filled_vector< Vector >();
+
+        for (auto _ : state) {
+            typename Vector::value_type sum {};
+            for (const auto &value : vector) {
+                sum += value;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * Read_size);
+    }
+
+    // Same scan over the contiguous blocks of concurrent_vector::segments()
+    void BM_vector_iterate_segments(benchmark::State &state) {
+        const auto &vector = Filled_vector< concurrent::concurrent_vector< int > >();
+
+        for (auto _ : state) {
+            int sum {};
+            for (const auto block : vector.segments()) {
+                for (const auto value : block) {
+                    sum += value;
+                }
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * Read_size);
+    }
+
+    // Contiguous copy of the whole vector, e.g. to hand it to code that needs a plain array
+    void BM_vector_snapshot(benchmark::State &state) {
+        const auto &vector = Filled_vector< concurrent::concurrent_vector< int > >();
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(vector.snapshot().data());
+        }
+        state.SetItemsProcessed(state.iterations() * Read_size);
+    }
+
+    // The scan of BM_vector_iterate_segments once compact() has merged the segments into one block
+    void BM_vector_iterate_compacted(benchmark::State &state) {
+        static const auto *compacted = []() {
+            auto vector = new concurrent::concurrent_vector< int > {};
+            for (std::int64_t i = 0; i < Read_size; ++i) {
+                vector->push_back(static_cast< int >(i));
+            }
+            vector->compact();
+            return vector;
+        }();
+
+        for (auto _ : state) {
+            int sum {};
+            for (const auto block : compacted->segments()) {
+                for (const auto value : block) {
+                    sum += value;
+                }
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * Read_size);
+    }
+
+    // Time the owning thread spends emptying a vector of heap-allocated strings: clear, clear_parallel, or
+    // clear_deferred, whose background destruction is waited for outside the timed region
+    template < int Mode >
+    void BM_vector_clear(benchmark::State &state) {
+        constexpr std::int64_t clear_size = 1 << 20;
+
+        concurrent::concurrent_vector< std::string > vector {};
+        for (auto _ : state) {
+            state.PauseTiming();
+            vector.assign(clear_size, std::string(64, 'x'));
+            state.ResumeTiming();
+
+            if constexpr (Mode == 0) {
+                vector.clear();
+            } else if constexpr (Mode == 1) {
+                vector.clear_parallel();
+            } else {
+                auto destroyed = vector.clear_deferred();
+                state.PauseTiming();
+                destroyed.get();
+                state.ResumeTiming();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * clear_size);
+    }
+
+} // namespace
+
+BENCHMARK(BM_vector_iterate_segments);
+BENCHMARK(BM_vector_iterate_compacted);
+BENCHMARK(BM_vector_snapshot);
+BENCHMARK_TEMPLATE(BM_vector_clear, 0)->Name("BM_vector_clear/serial")->UseRealTime();
+BENCHMARK_TEMPLATE(BM_vector_clear, 1)->Name("BM_vector_clear/parallel")->UseRealTime();
+BENCHMARK_TEMPLATE(BM_vector_clear, 2)->Name("BM_vector_clear/deferred")->UseRealTime();
+
+#define CONCURRENT_VECTOR_BENCHMARKS(vector_type)                                                                 \
+    BENCHMARK_TEMPLATE(BM_vector_push_back, vector_type< int >)->ThreadRange(1, Max_threads)->UseRealTime();    \
+    BENCHMARK_TEMPLATE(BM_vector_random_read, vector_type< int >)->ThreadRange(1, Max_threads)->UseRealTime();  \
+    BENCHMARK_TEMPLATE(BM_vector_iterate, vector_type< int >)
+
+CONCURRENT_VECTOR_BENCHMARKS(concurrent::concurrent_vector);
+CONCURRENT_VECTOR_BENCHMARKS(Mutex_vector);
+#ifdef CONCURRENT_BENCHMARK_TBB
+CONCURRENT_VECTOR_BENCHMARKS(tbb::concurrent_vector);
+#endif
+#ifdef CONCURRENT_BENCHMARK_CONCRT
+CONCURRENT_VECTOR_BENCHMARKS(Concurrency::concurrent_vector);
+#endif
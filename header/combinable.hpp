@@ -2,12 +2,15 @@
 #define COMBINABLE_HPP
 
 #include <array>
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <numeric>
 #include <thread>
 #include <type_traits>
 #include <utility>
+#include <utils.h>
+#include <vector>
 
 namespace concurrent {
 
@@ -17,12 +20,13 @@ namespace concurrent {
         using value_type = Type;
 
       private:
-        struct Storage {
+        // Each unit owns whole cache lines so per-thread updates never contend with a neighbour
+        struct alignas(impl::Cache_line_size) Storage {
+            value_type      mValue; // First, so the hot field starts on the line boundary
             std::thread::id mThreadID;
-            value_type      mValue;
             Storage*        nextStorage;
 
-            constexpr Storage(std::thread::id threadID, value_type value) : mThreadID(threadID), mValue(value) {}
+            constexpr Storage(std::thread::id threadID, value_type value) : mValue(value), mThreadID(threadID) {}
             constexpr ~Storage() = default;
         };
 
@@ -40,12 +44,25 @@ namespace concurrent {
 
         static constexpr auto Min_size = Bucket_size_eval< ThreadCount >::value;
 
+        // Per-thread, direct-mapped by instance id; ids are never reused, so stale entries simply miss
+        struct Cache_entry {
+            std::size_t mInstanceID = 0;
+            Storage*    mStorage    = nullptr;
+        };
+
+        static constexpr std::size_t Cache_size = 4;
+
+        static constexpr std::ptrdiff_t Parallel_grain = 4; // Units folded serially by one reduction task
+
       public:
-        constexpr combinable() { mBuckets.fill(nullptr); }
+        constexpr combinable() {}
 
         constexpr ~combinable() { Finalise(); }
 
-        constexpr void clear() { Finalise(); }
+        void clear() {
+            Finalise();
+            mInstanceID = Next_instance_id(); // Drop every thread's cached unit
+        }
 
         template < class Functor >
         requires(std::is_invocable_r_v< value_type, Functor, value_type, value_type >) value_type
@@ -53,10 +70,10 @@ namespace concurrent {
             Storage*    starting_storage = nullptr;
             std::size_t starting_index   = 0;
 
-            for (auto bucket : mBuckets) { // Look for the first initialized bucket
+            for (const auto& bucket : mBuckets) { // Look for the first initialized bucket
                 ++starting_index;
-                if (bucket) {
-                    starting_storage = bucket;
+                if (auto head = bucket.load(std::memory_order_acquire)) {
+                    starting_storage = head;
                     break;
                 }
             }
@@ -73,7 +90,7 @@ namespace concurrent {
             }
 
             for (; starting_index < Min_size; ++starting_index) {
-                starting_storage = mBuckets[starting_index];
+                starting_storage = mBuckets[starting_index].load(std::memory_order_acquire);
                 while (starting_storage) {
                     result           = func(result, starting_storage->mValue);
                     starting_storage = starting_storage->nextStorage;
@@ -83,10 +100,33 @@ namespace concurrent {
             return result;
         }
 
+        // Tree reduction over the units, the halves are folded as tasks of the executor. func is called
+        // concurrently and in the same left-to-right order as combine, so it only needs to be associative.
+        // The executor must not run the tasks on a fixed pool whose workers are the ones blocked in get()
+        template < class Functor, class Executor = async_executor >
+        requires(std::is_invocable_r_v< value_type, Functor, value_type, value_type >) value_type
+            combine_parallel(Functor func, Executor executor = Executor {}) const {
+            std::vector< const value_type* > values {};
+            combine_each([&values](const value_type& value) { values.push_back(std::addressof(value)); });
+
+            if (values.empty()) {
+                return value_type {};
+            }
+
+            return Reduce_range(values.data(), values.data() + values.size(), func, executor);
+        }
+
+        // Folds every unit into result in place, avoiding a value_type copy per step
+        template < class Functor >
+        requires(std::is_invocable_v< Functor, value_type&, const value_type& >) void
+            combine_into(value_type& result, Functor func) const {
+            combine_each([&result, &func](const value_type& value) { func(result, value); });
+        }
+
         template < typename Functor >
         requires(std::is_invocable_r_v< void, Functor, value_type >) void combine_each(Functor func) const {
-            for (auto bucket : mBuckets) {
-                auto storage_unit = bucket;
+            for (const auto& bucket : mBuckets) {
+                auto storage_unit = bucket.load(std::memory_order_acquire);
                 while (storage_unit) {
                     func(storage_unit->mValue);
                     storage_unit = storage_unit->nextStorage;
@@ -94,7 +134,12 @@ namespace concurrent {
             }
         }
 
-        constexpr value_type& local() {
+        value_type& local() {
+            auto& entry = Thread_cache()[mInstanceID % Cache_size];
+            if (entry.mInstanceID == mInstanceID) {
+                return entry.mStorage->mValue;
+            }
+
             auto thread_id                    = std::this_thread::get_id();
             auto [storage_unit, bucket_index] = Get_local_storage_unit(thread_id);
 
@@ -102,10 +147,17 @@ namespace concurrent {
                 storage_unit = Add_local_storage_unit(thread_id, bucket_index);
             }
 
+            entry = Cache_entry { mInstanceID, storage_unit };
             return storage_unit->mValue;
         }
 
-        constexpr value_type& local(bool& exists) {
+        value_type& local(bool& exists) {
+            auto& entry = Thread_cache()[mInstanceID % Cache_size];
+            if (entry.mInstanceID == mInstanceID) {
+                exists = true;
+                return entry.mStorage->mValue;
+            }
+
             auto thread_id                    = std::this_thread::get_id();
             auto [storage_unit, bucket_index] = Get_local_storage_unit(thread_id);
 
@@ -116,6 +168,7 @@ namespace concurrent {
                 exists = true;
             }
 
+            entry = Cache_entry { mInstanceID, storage_unit };
             return storage_unit->mValue;
         }
 
@@ -126,47 +179,99 @@ namespace concurrent {
             }
         }
 
-        void Delete_storage_units_in_bucket_ptr(Storage* bucket) noexcept {
+        void Delete_storage_units_in_bucket_ptr(std::atomic< Storage* >& bucket) noexcept {
             auto alloc        = std::allocator< Storage > {};
-            auto storage_unit = bucket;
-            bucket            = nullptr;
+            auto storage_unit = bucket.exchange(nullptr, std::memory_order_acquire);
             while (storage_unit) {
                 auto delete_unit = storage_unit;
                 storage_unit     = storage_unit->nextStorage;
 
+                std::allocator_traits< std::allocator< Storage > >::destroy(alloc, delete_unit);
                 alloc.deallocate(delete_unit, 1);
             }
         }
 
+        template < class Functor, class Executor >
+        static value_type Reduce_range(const value_type* const* first, const value_type* const* last, Functor& func,
+                                       Executor& executor) {
+            const auto count = last - first;
+            if (count <= Parallel_grain) {
+                value_type result = **first;
+                for (++first; first != last; ++first) {
+                    result = func(std::move(result), **first);
+                }
+                return result;
+            }
+
+            const auto middle = first + count / 2;
+            auto       left   = executor(
+                [first, middle, &func, &executor]() { return Reduce_range(first, middle, func, executor); });
+
+            value_type right;
+            try {
+                right = Reduce_range(middle, last, func, executor);
+            } catch (...) {
+                try { // The task still references func and executor, it has to finish first
+                    left.get();
+                } catch (...) {
+                }
+                throw;
+            }
+
+            return func(left.get(), std::move(right));
+        }
+
+        static std::size_t Next_instance_id() noexcept {
+            static std::atomic< std::size_t > counter { 0 };
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1; // 0 marks an empty cache entry
+        }
+
+        static std::array< Cache_entry, Cache_size >& Thread_cache() noexcept {
+            thread_local std::array< Cache_entry, Cache_size > cache {};
+            return cache;
+        }
+
         constexpr auto Get_local_storage_unit(std::thread::id thread_id) const {
             Storage*    storage_unit = nullptr;
             std::size_t bucket_index = std::hash< std::thread::id > {}(thread_id) % Min_size;
 
-            Storage* current_unit = mBuckets[bucket_index];
+            // Units are only ever prepended and never unlinked while threads call local(), so no lock is needed
+            Storage* current_unit = mBuckets[bucket_index].load(std::memory_order_acquire);
 
             while (current_unit) {
                 if (current_unit->mThreadID == thread_id) {
                     return std::make_pair(current_unit, bucket_index);
                 }
+                current_unit = current_unit->nextStorage;
             }
 
             return std::make_pair(storage_unit, bucket_index);
         }
 
-        constexpr auto Add_local_storage_unit(std::thread::id thread_id, std::size_t bucket_index) {
-            auto alloc  = std::allocator< Storage > {};
-            auto bucket = mBuckets[bucket_index];
+        // Only the calling thread registers its own id, so a failed CAS just means another thread prepended first
+        auto Add_local_storage_unit(std::thread::id thread_id, std::size_t bucket_index) {
+            auto  alloc  = std::allocator< Storage > {};
+            auto& bucket = mBuckets[bucket_index];
 
             auto new_storage = alloc.allocate(1);
-            std::allocator_traits< std::allocator< Storage > >::construct(alloc, new_storage, thread_id, value_type {});
+            try {
+                std::allocator_traits< std::allocator< Storage > >::construct(alloc, new_storage, thread_id,
+                                                                              value_type {});
+            } catch (...) {
+                alloc.deallocate(new_storage, 1);
+                throw;
+            }
 
-            new_storage->nextStorage = bucket;
-            mBuckets[bucket_index]   = new_storage;
+            new_storage->nextStorage = bucket.load(std::memory_order_relaxed);
+            while (!bucket.compare_exchange_weak(new_storage->nextStorage, new_storage, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+            }
 
             return new_storage;
         }
 
-        std::array< Storage*, Min_size > mBuckets;
+        std::array< std::atomic< Storage* >, Min_size > mBuckets {};
+        std::size_t                                     mInstanceID = Next_instance_id();
     };
 
 } // namespace concurrent
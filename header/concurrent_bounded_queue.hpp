@@ -0,0 +1,188 @@
+#ifndef CONCURRENT_BOUNDED_QUEUE_HPP
+#define CONCURRENT_BOUNDED_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concurrent_queue.hpp>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <utility>
+
+namespace concurrent {
+
+    /// <summary>
+    /// concurrent_queue with a capacity limit. push blocks while the queue is full and pop blocks
+    /// while it is empty, blocked threads sleep on std::atomic::wait until the other side notifies them.
+    /// </summary>
+    template < class Type, class Allocator = std::allocator< Type > >
+    class concurrent_bounded_queue {
+      private:
+        using queue_type = concurrent_queue< Type, Allocator >;
+        using epoch_type = std::uint32_t; // Futex sized so waiting maps onto the native wait primitive
+
+        static constexpr auto Min_backoff = std::chrono::microseconds { 50 };
+        static constexpr auto Max_backoff = std::chrono::milliseconds { 1 };
+
+      public:
+        using value_type      = typename queue_type::value_type;
+        using allocator_type  = typename queue_type::allocator_type;
+        using size_type       = typename queue_type::size_type;
+        using difference_type = typename queue_type::difference_type;
+        using reference       = typename queue_type::reference;
+        using const_reference = typename queue_type::const_reference;
+
+        explicit concurrent_bounded_queue(const allocator_type &allocator = allocator_type {}) : mQueue(allocator) {}
+
+        explicit concurrent_bounded_queue(size_type capacity, const allocator_type &allocator = allocator_type {}) :
+            mQueue(allocator), mCapacity(capacity) {}
+
+        concurrent_bounded_queue(const concurrent_bounded_queue &) = delete;
+        concurrent_bounded_queue &operator=(const concurrent_bounded_queue &) = delete;
+
+        ~concurrent_bounded_queue() = default;
+
+        // Blocks while the queue is full
+        void push(const Type &value) {
+            Reserve_slot();
+            Publish(value);
+        }
+
+        // Blocks while the queue is full
+        void push(Type &&value) {
+            Reserve_slot();
+            Publish(std::move(value));
+        }
+
+        bool try_push(const Type &value) {
+            if (!Try_reserve_slot()) {
+                return false;
+            }
+            Publish(value);
+            return true;
+        }
+
+        bool try_push(Type &&value) {
+            if (!Try_reserve_slot()) {
+                return false;
+            }
+            Publish(std::move(value));
+            return true;
+        }
+
+        // Blocks while the queue is empty
+        void pop(Type &dest) {
+            for (;;) {
+                const auto items = mItemsEpoch.load(std::memory_order_acquire);
+                if (try_pop(dest)) {
+                    return;
+                }
+                mItemsEpoch.wait(items, std::memory_order_acquire);
+            }
+        }
+
+        bool try_pop(Type &dest) {
+            if (!mQueue.try_pop(dest)) {
+                return false;
+            }
+            Release_slot();
+            return true;
+        }
+
+        template < class Rep, class Period >
+        bool try_pop_for(Type &dest, const std::chrono::duration< Rep, Period > &timeout) {
+            // std::atomic offers no timed wait, the deadline is approached with growing sleeps instead
+            const auto deadline =
+                std::chrono::steady_clock::now() + std::chrono::ceil< std::chrono::steady_clock::duration >(timeout);
+            std::chrono::steady_clock::duration backoff = Min_backoff;
+            for (;;) {
+                if (try_pop(dest)) {
+                    return true;
+                }
+
+                const auto now = std::chrono::steady_clock::now();
+                if (now >= deadline) {
+                    return false;
+                }
+
+                std::this_thread::sleep_for(std::min(backoff, deadline - now));
+                backoff = std::min< std::chrono::steady_clock::duration >(backoff * 2, Max_backoff);
+            }
+        }
+
+        // Shrinking below the current size only blocks producers until consumers drained the excess
+        void set_capacity(const size_type capacity) {
+            mCapacity.store(capacity);
+            mSpaceEpoch.fetch_add(1, std::memory_order_release);
+            mSpaceEpoch.notify_all();
+        }
+
+        [[nodiscard]] size_type capacity() const noexcept { return mCapacity.load(); }
+
+        // Includes elements whose push is still in flight
+        [[nodiscard]] size_type size() const noexcept { return mSize.load(); }
+
+        [[nodiscard]] bool empty() const { return mQueue.empty(); }
+
+        [[nodiscard]] allocator_type get_allocator() const { return mQueue.get_allocator(); }
+
+        // Not concurrency-safe
+        void clear() {
+            mQueue.clear();
+            mSize.store(0);
+            mSpaceEpoch.fetch_add(1, std::memory_order_release);
+            mSpaceEpoch.notify_all();
+        }
+
+      private:
+        void Reserve_slot() {
+            for (;;) {
+                const auto space = mSpaceEpoch.load(std::memory_order_acquire);
+                if (Try_reserve_slot()) {
+                    return;
+                }
+                mSpaceEpoch.wait(space, std::memory_order_acquire);
+            }
+        }
+
+        bool Try_reserve_slot() noexcept {
+            auto size = mSize.load();
+            while (size < mCapacity.load()) {
+                if (mSize.compare_exchange_weak(size, size + 1)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void Release_slot() noexcept {
+            mSize.fetch_sub(1);
+            mSpaceEpoch.fetch_add(1, std::memory_order_release);
+            mSpaceEpoch.notify_one();
+        }
+
+        template < class Value >
+        void Publish(Value &&value) {
+            try {
+                mQueue.push(std::forward< Value >(value));
+            } catch (...) {
+                Release_slot();
+                throw;
+            }
+            mItemsEpoch.fetch_add(1, std::memory_order_release);
+            mItemsEpoch.notify_one();
+        }
+
+        queue_type mQueue {};
+
+        std::atomic< size_type > mCapacity { std::numeric_limits< size_type >::max() };
+        std::atomic< size_type > mSize { 0 }; // Slots reserved by producers and not yet released by consumers
+
+        std::atomic< epoch_type > mSpaceEpoch { 0 }; // Bumped whenever a slot may have become free
+        std::atomic< epoch_type > mItemsEpoch { 0 }; // Bumped whenever an element was published
+    };
+
+} // namespace concurrent
+
+#endif // CONCURRENT_BOUNDED_QUEUE_HPP
@@ -0,0 +1,325 @@
+#ifndef CONCURRENT_PRIORITY_QUEUE_HPP
+#define CONCURRENT_PRIORITY_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <concurrent_vector.hpp>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <utils.h>
+
+namespace concurrent {
+
+    /// <summary>
+    /// Priority queue built on flat combining. A thread publishes its push or pop as a request on a lock-free
+    /// list, the thread that finds the list empty becomes the combiner and applies the whole batch to the heap
+    /// while the others wait on their own request. The heap is 4-ary, so a sift touches a quarter of the
+    /// levels of a binary heap and the children of a node share a cache line. It is stored in a
+    /// concurrent_vector, which only the combiner modifies.
+    /// Like std::priority_queue the greatest element by Compare is popped first. Comparing and moving elements
+    /// must not throw, a sift that failed halfway would leave the heap out of order.
+    /// </summary>
+    template < class Type, class Compare = std::less< Type >, class Allocator = std::allocator< Type > >
+    class concurrent_priority_queue {
+        static_assert(std::is_same_v< Type, typename Allocator::value_type >,
+                      "concurrent_priority_queue<T, Compare, Allocator> requires its allocator type to match T");
+
+      private:
+        using storage_type = concurrent_vector< Type, Allocator >;
+
+      public:
+        using value_type      = Type;
+        using value_compare   = Compare;
+        using allocator_type  = Allocator;
+        using size_type       = typename storage_type::size_type;
+        using difference_type = typename storage_type::difference_type;
+        using reference       = Type &;
+        using const_reference = const Type &;
+
+      private:
+        static constexpr size_type Arity = 4;
+
+        enum class Operation_kind : std::uint8_t { push_copy, push_move, pop };
+        enum class Operation_status : std::uint8_t { pending, succeeded, failed };
+
+        // Lives on the stack of the requesting thread until the combiner sets its status
+        struct Operation {
+            Operation_kind                  mKind;
+            Type *                          mValue; // Source of a push, destination of a pop
+            Operation *                     mNext { nullptr };
+            std::exception_ptr              mError {};
+            std::atomic< Operation_status > mStatus { Operation_status::pending };
+        };
+
+      public:
+        explicit concurrent_priority_queue(const allocator_type &allocator = allocator_type {}) :
+            mHeap(allocator) {}
+
+        explicit concurrent_priority_queue(const size_type init_capacity,
+                                           const allocator_type &allocator = allocator_type {}) :
+            mHeap(allocator) {
+            mHeap.reserve(init_capacity);
+        }
+
+        template < class InputIt >
+        requires(traits::legacy_input_iterator< InputIt >)
+            concurrent_priority_queue(InputIt first, InputIt last,
+                                      const allocator_type &allocator = allocator_type {}) :
+            mHeap(first, last, allocator) {
+            Make_heap(0);
+        }
+
+        concurrent_priority_queue(std::initializer_list< Type > iList,
+                                  const allocator_type &allocator = allocator_type {}) :
+            concurrent_priority_queue(iList.begin(), iList.end(), allocator) {}
+
+        // Not concurrency-safe
+        concurrent_priority_queue(const concurrent_priority_queue &rhs) : mHeap(rhs.mHeap), mCompare(rhs.mCompare) {}
+
+        concurrent_priority_queue(const concurrent_priority_queue &rhs, const allocator_type &allocator) :
+            mHeap(rhs.mHeap, allocator), mCompare(rhs.mCompare) {}
+
+        concurrent_priority_queue(concurrent_priority_queue &&rhs) noexcept :
+            mHeap(std::move(rhs.mHeap)), mCompare(std::move(rhs.mCompare)) {}
+
+        // Not concurrency-safe
+        concurrent_priority_queue &operator=(const concurrent_priority_queue &rhs) {
+            if (this != std::addressof(rhs)) {
+                mHeap    = rhs.mHeap;
+                mCompare = rhs.mCompare;
+            }
+            return *this;
+        }
+
+        // Goes through the move constructor and swap, concurrent_vector has no move assignment yet
+        concurrent_priority_queue &operator=(concurrent_priority_queue &&rhs) noexcept(
+            std::is_nothrow_move_constructible_v< Compare > && std::is_nothrow_swappable_v< Compare >) {
+            if (this != std::addressof(rhs)) {
+                concurrent_priority_queue(std::move(rhs)).swap(*this);
+            }
+            return *this;
+        }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return mHeap.get_allocator(); }
+
+        /// Modifiers - concurrency-safe
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        void push(const Type &value) {
+            Execute(Operation_kind::push_copy, const_cast< Type * >(std::addressof(value)));
+        }
+
+        void push(Type &&value) { Execute(Operation_kind::push_move, std::addressof(value)); }
+
+        template < class... Args >
+        void emplace(Args &&...args) {
+            push(Type(std::forward< Args >(args)...));
+        }
+
+        // Moves the greatest element into dest, returns false if the queue was empty
+        bool try_pop(Type &dest) { return Execute(Operation_kind::pop, std::addressof(dest)); }
+
+        /// Capacity - concurrency-safe, the result may already be stale
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        [[nodiscard]] size_type size() const noexcept { return mHeap.size(); }
+
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+        /// Not concurrency-safe
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        void clear() noexcept { mHeap.clear(); }
+
+        void swap(concurrent_priority_queue &rhs) noexcept(std::is_nothrow_swappable_v< Compare >) {
+            mHeap.swap(rhs.mHeap);
+            std::swap(mCompare, rhs.mCompare);
+        }
+
+      private:
+        // Publishes a request and waits until a combiner, possibly this thread, has applied it
+        bool Execute(const Operation_kind kind, Type *value) {
+            Operation operation { kind, value };
+
+            auto head = mPending.load(std::memory_order_relaxed);
+            do {
+                operation.mNext = head;
+            } while (!mPending.compare_exchange_weak(head, &operation, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+
+            if (head == nullptr) {
+                Combine();
+            } else {
+                while (operation.mStatus.load(std::memory_order_acquire) == Operation_status::pending) {
+                    std::this_thread::yield();
+                }
+            }
+
+            if (operation.mError) {
+                std::rethrow_exception(operation.mError);
+            }
+            return operation.mStatus.load(std::memory_order_relaxed) == Operation_status::succeeded;
+        }
+
+        /// <summary>
+        /// Run by the thread whose request started a batch. A previous combiner may still be busy with its own
+        /// batch, which was detached from the list before this one started. Pushes of the batch are appended
+        /// first and restored into heap order together, then the pops take the greatest elements.
+        /// </summary>
+        void Combine() noexcept {
+            while (mCombining.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            auto       batch       = mPending.exchange(nullptr, std::memory_order_acquire);
+            const auto heap_before = mHeap.size();
+
+            Operation *pops = nullptr;
+            while (batch) {
+                const auto operation = std::exchange(batch, batch->mNext);
+                if (operation->mKind == Operation_kind::pop) {
+                    operation->mNext = std::exchange(pops, operation);
+                } else {
+                    Finish(operation, Append(*operation));
+                }
+            }
+            Make_heap(heap_before);
+
+            while (pops) {
+                const auto operation = std::exchange(pops, pops->mNext);
+                Finish(operation, Pop_top(*operation));
+            }
+
+            mCombining.store(false, std::memory_order_release);
+        }
+
+        // Wakes the requesting thread, which may return and free the operation right away
+        static void Finish(Operation *operation, const bool succeeded) noexcept {
+            operation->mStatus.store(succeeded ? Operation_status::succeeded : Operation_status::failed,
+                                     std::memory_order_release);
+        }
+
+        bool Append(Operation &operation) noexcept {
+            try {
+                if constexpr (std::is_copy_constructible_v< Type >) {
+                    if (operation.mKind == Operation_kind::push_copy) {
+                        mHeap.push_back(std::as_const(*operation.mValue));
+                        return true;
+                    }
+                }
+                mHeap.push_back(std::move(*operation.mValue));
+                return true;
+            } catch (...) {
+                mHeap.pop_back(); // Gives back the index the failed append reserved
+                operation.mError = std::current_exception();
+                return false;
+            }
+        }
+
+        bool Pop_top(Operation &operation) noexcept {
+            const auto size = mHeap.size();
+            if (size == 0) {
+                return false;
+            }
+
+            try {
+                *operation.mValue = std::move(mHeap[0]);
+            } catch (...) {
+                operation.mError = std::current_exception();
+                return false;
+            }
+
+            if (size > 1) {
+                auto last = std::move(mHeap[size - 1]);
+                mHeap.pop_back();
+                Sift_down(0, std::move(last));
+            } else {
+                mHeap.pop_back();
+            }
+            return true;
+        }
+
+        // Restores heap order after elements were appended behind the first `valid` ones, rebuilding
+        // bottom-up when the batch is large against the heap
+        void Make_heap(const size_type valid) noexcept {
+            const auto size = mHeap.size();
+            if (size - valid <= valid / Arity) {
+                for (auto index = valid; index < size; ++index) {
+                    Sift_up(index);
+                }
+                return;
+            }
+
+            if (size < 2) {
+                return;
+            }
+            for (auto index = Parent_of(size - 1) + 1; index-- > 0;) {
+                auto value = std::move(mHeap[index]);
+                Sift_down(index, std::move(value));
+            }
+        }
+
+        [[nodiscard]] static constexpr size_type Parent_of(const size_type index) noexcept {
+            return (index - 1) / Arity;
+        }
+
+        // The sifts keep a pointer to the hole, every element is looked up in the segment table once
+        void Sift_up(size_type index) noexcept {
+            auto value = std::move(mHeap[index]);
+            auto hole  = std::addressof(mHeap[index]);
+            while (index > 0) {
+                const auto parent = Parent_of(index);
+                const auto above  = std::addressof(mHeap[parent]);
+                if (!mCompare(*above, value)) {
+                    break;
+                }
+                *hole = std::move(*above);
+                hole  = above;
+                index = parent;
+            }
+            *hole = std::move(value);
+        }
+
+        // Moves the hole at index down to where value belongs
+        void Sift_down(size_type index, Type &&value) noexcept {
+            const auto size = mHeap.size();
+            auto       hole = std::addressof(mHeap[index]);
+            for (;;) {
+                const auto first_child = index * Arity + 1;
+                if (first_child >= size) {
+                    break;
+                }
+
+                auto       greatest       = std::addressof(mHeap[first_child]);
+                auto       greatest_index = first_child;
+                const auto last_child     = std::min(first_child + Arity, size);
+                for (auto child = first_child + 1; child < last_child; ++child) {
+                    if (const auto candidate = std::addressof(mHeap[child]); mCompare(*greatest, *candidate)) {
+                        greatest       = candidate;
+                        greatest_index = child;
+                    }
+                }
+
+                if (!mCompare(value, *greatest)) {
+                    break;
+                }
+                *hole = std::move(*greatest);
+                hole  = greatest;
+                index = greatest_index;
+            }
+            *hole = std::move(value);
+        }
+
+        alignas(impl::Cache_line_size) std::atomic< Operation * > mPending { nullptr }; // Requests of the next batch
+        alignas(impl::Cache_line_size) std::atomic< bool > mCombining { false };
+
+        storage_type                        mHeap;
+        [[no_unique_address]] value_compare mCompare {};
+    };
+
+} // namespace concurrent
+
+#endif // CONCURRENT_PRIORITY_QUEUE_HPP
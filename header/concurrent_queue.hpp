@@ -1,10 +1,23 @@
 #ifndef CONCURRENT_QUEUE_HPP
 #define CONCURRENT_QUEUE_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <container_stats.hpp>
+#include <coroutine>
+#include <cstring>
+#include <epoch_reclaimer.hpp>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <utils.h>
+#include <vector>
 
 namespace concurrent {
 
@@ -34,8 +47,7 @@ namespace concurrent {
             isValid(false) {}
         concurrent_queue_iterator(MyQueue *mini_queue, MiniQueue *node_location, size_type idx_in_node) :
             mQueue(mini_queue), mMiniQueue(node_location), mElementIdxInMiniQueue(idx_in_node), isValid(true) {
-            const auto size = mini_queue->unsafe_size();
-            if (size == 0) {
+            if (node_location == End_iterator_ptr) {
                 Invalidate();
             }
 #ifdef CONCURRENT_QUEUE_DEVELOPER_DEBUG
@@ -150,24 +162,175 @@ namespace concurrent {
         using const_iterator = concurrent_queue_iterator< Type >;
 
       private:
+        // Life cycle of a single element slot:
+        // Empty -> Busy -> Ready, a producer claimed the slot, constructed the element and published it
+        // Empty -> Taken, a consumer reached the slot first and poisoned it, the producer has to claim another one
+        // Busy -> Taken, the element constructor threw
+        enum class Slot_state : unsigned char { Empty, Busy, Ready, Taken };
+
+        /// <summary>
+        /// A fixed-size segment of the queue. Producers and consumers claim slots by drawing tickets
+        /// with fetch_add, a ticket at or past the segment capacity means the segment is exhausted.
+        /// mBase numbers the first slot of the segment among all slots the queue ever linked, so the
+        /// queue size can be read off the head and tail segments without walking the chain.
+        /// The read-mostly fields, the producers' ticket and the consumers' ticket sit on their own cache
+        /// lines, so a push and a pop on the same segment do not invalidate each other's line.
+        /// </summary>
         struct MiniQueue {
-            value_type *mElements { nullptr };
-            value_type *mBegin { nullptr };
-            value_type *mUsedBegin { nullptr };
-            value_type *mCurrent { nullptr };
-            value_type *mEnd { nullptr };
-            MiniQueue * mNextQueue { nullptr };
+            value_type *                mBegin { nullptr };
+            value_type *                mEnd { nullptr };
+            size_type                   mBase { 0 };
+            std::atomic< Slot_state > * mStates { nullptr };
+            std::atomic< MiniQueue * >  mNextQueue { nullptr };
+            MiniQueue *                 mRetiredNext { nullptr };
+            impl::epoch_type            mRetireEpoch { 0 };
+
+            alignas(impl::Cache_line_size) std::atomic< size_type > mPushTicket { 0 };
+            alignas(impl::Cache_line_size) std::atomic< size_type > mPopTicket { 0 };
         };
 
-        using mini_queue_allocator        = std::allocator< MiniQueue >;
+        // Segment nodes and slot states come from the user's allocator as well, so a pooling allocator
+        // covers every allocation a segment needs
+        using slot_state = std::atomic< Slot_state >;
+
+        using mini_queue_allocator        = typename allocator_traits::template rebind_alloc< MiniQueue >;
         using mini_queue_allocator_traits = std::allocator_traits< mini_queue_allocator >;
+        using slot_state_allocator        = typename allocator_traits::template rebind_alloc< slot_state >;
+        using slot_state_allocator_traits = std::allocator_traits< slot_state_allocator >;
+
+        using segment_sizing = impl::Segment_sizing< Type, size_type >;
 
-        static constexpr size_type Min_queue_size = impl::Min_segment_size_eval< Type, size_type >::value;
+        static constexpr size_type Min_queue_size = segment_sizing::Initial_size;
+
+        // How many times a producer that overflowed a segment yields to the one allocating its successor
+        // before it allocates on its own
+        static constexpr int Append_spin_count = 64;
+
+        // clear_parallel hands out slots in pieces of about 256KB of elements
+        static constexpr size_type Parallel_clear_grain =
+            std::max< size_type >(1, (static_cast< size_type >(1) << 18) / sizeof(Type));
+
+        // Drained segments go back to the spare slot once no operation can still be reading them
+        struct Mini_queue_recycler {
+            const concurrent_queue *mOwner;
+
+            void operator()(MiniQueue *queue) const noexcept { mOwner->Recycle_mini_queue(queue); }
+        };
+
+        // Segments retire rarely but can be large, a small batch keeps them from piling up per thread
+        static constexpr std::size_t Retire_batch_size = 4;
+
+        using epoch_reclaimer = impl::Epoch_reclaimer< MiniQueue, Mini_queue_recycler, Retire_batch_size >;
+
+        // Every operation touching the segment chain runs inside a guard, a drained segment is only recycled
+        // once every operation that could have seen it has finished
+        using Operation_guard = typename epoch_reclaimer::Guard;
 
         template < class TType >
-        friend class concurrent_queue_iterator;
+        friend struct concurrent_queue_iterator;
 
       public:
+        /// <summary>
+        /// Awaitable returned by async_pop. A coroutine that finds the queue empty is parked on the queue's
+        /// waiter list, the next push hands it an element and resumes it on the pushing thread. It resumes
+        /// with std::nullopt once the queue is closed and no element is left for it.
+        /// </summary>
+        class pop_awaiter {
+          public:
+            explicit pop_awaiter(concurrent_queue &queue) noexcept : mQueue(queue) {}
+
+            pop_awaiter(const pop_awaiter &) = delete;
+            pop_awaiter &operator=(const pop_awaiter &) = delete;
+
+            bool await_ready() { return mQueue.Pop_into(mResult) || mQueue.is_closed(); }
+
+            bool await_suspend(const std::coroutine_handle<> handle) { return mQueue.Suspend_waiter(*this, handle); }
+
+            std::optional< Type > await_resume() { return std::move(mResult); }
+
+          private:
+            friend class concurrent_queue;
+
+            concurrent_queue &      mQueue;
+            std::optional< Type >   mResult {};
+            std::coroutine_handle<> mHandle {};
+            pop_awaiter *           mNext { nullptr };
+        };
+
+        /// <summary>
+        /// A slot claimed by reserve_slot. The producer builds the element in place with emplace, fills it
+        /// through get(), e.g. by decoding a network buffer straight into it, and makes it visible with commit.
+        /// A handle dropped without a commit gives the slot up, consumers skip it.
+        /// Consumers that reach the slot wait for the commit, and the handle holds back segment reclamation
+        /// while it lives, so it should be committed promptly and on the thread that reserved it.
+        /// </summary>
+        class slot_reservation {
+          public:
+            slot_reservation(const slot_reservation &) = delete;
+            slot_reservation &operator=(const slot_reservation &) = delete;
+
+            ~slot_reservation() {
+                if (mQueue) {
+                    Abandon();
+                }
+            }
+
+            // Constructs the element, at most once per reservation. If the constructor throws the slot stays
+            // reserved and can be built again
+            template < class... Args >
+            Type &emplace(Args &&...args) {
+                assert(mQueue && !mConstructed && "the slot already holds an element");
+                allocator_traits::construct(mOwner.mAllocator, unfancy_ptr(Element()), std::forward< Args >(args)...);
+                mConstructed = true;
+                return *Element();
+            }
+
+            // The element built by emplace, nullptr before that
+            [[nodiscard]] Type *get() const noexcept { return mConstructed ? Element() : nullptr; }
+
+            [[nodiscard]] bool has_value() const noexcept { return mConstructed; }
+
+            // Publishes the element to consumers. Without one the slot is given up instead
+            void commit() {
+                assert(mQueue && "the reservation was already committed");
+                if (!mConstructed) {
+                    Abandon();
+                    return;
+                }
+
+                std::exchange(mQueue, nullptr)->mStates[mSlot].store(Slot_state::Ready, std::memory_order_release);
+                mOwner.mStats.Count_push();
+                mGuard.reset();
+                mOwner.Notify_waiters();
+            }
+
+          private:
+            friend class concurrent_queue;
+
+            explicit slot_reservation(concurrent_queue &owner) :
+                mOwner(owner), mGuard(std::in_place, owner.mReclaimer) {
+                const auto [queue, slot] = owner.Claim_slot();
+                mQueue                   = queue;
+                mSlot                    = slot;
+            }
+
+            [[nodiscard]] Type *Element() const noexcept { return unfancy_ptr(mQueue->mBegin + mSlot); }
+
+            void Abandon() noexcept {
+                if (mConstructed) {
+                    mOwner.Destroy_element(Element());
+                }
+                std::exchange(mQueue, nullptr)->mStates[mSlot].store(Slot_state::Taken, std::memory_order_release);
+                mGuard.reset();
+            }
+
+            concurrent_queue &               mOwner;
+            std::optional< Operation_guard > mGuard;
+            MiniQueue *                      mQueue { nullptr };
+            size_type                        mSlot { 0 };
+            bool                             mConstructed { false };
+        };
+
         explicit concurrent_queue(const allocator_type &allocator = allocator_type {}) : mAllocator(allocator) {}
 
         concurrent_queue(const concurrent_queue &queue, const allocator_type &allocator = allocator_type {}) :
@@ -176,7 +339,18 @@ namespace concurrent {
         }
 
         concurrent_queue(concurrent_queue &&queue, const allocator_type &allocator = allocator_type {}) :
-            mQueue(std::exchange(queue.mQueue, nullptr)), mAllocator(allocator) {}
+            mQueue(queue.mQueue.exchange(nullptr)),
+            mQueueEnd(queue.mQueueEnd.exchange(nullptr)),
+            mSpareQueue(queue.mSpareQueue.exchange(nullptr)),
+            mCapacity(queue.mCapacity.exchange(0)),
+            mAllocator(allocator) {
+            // The segments change owner and take their share of bytes_held with them
+            if constexpr (container_stats::enabled) {
+                const auto bytes = Held_bytes();
+                queue.mStats.Count_release(bytes);
+                mStats.Count_adoption(bytes);
+            }
+        }
 
         template < typename InputIter >
         concurrent_queue(InputIter first, InputIter last) {
@@ -186,124 +360,557 @@ namespace concurrent {
         ~concurrent_queue() { Finalise(); }
 
         bool empty() const {
-            {
-                std::scoped_lock Guard { mMutex };
-                if (!mQueue) {
-                    return true;
-                }
-                return static_cast< bool >(mQueue->mCurrent == mQueue->mUsedBegin);
-            }
+            Operation_guard guard { mReclaimer };
+            return Approximate_size() == 0;
         }
 
-        allocator_type get_allocator() const {
-            std::scoped_lock Guard { mMutex };
-            auto             alloc = mAllocator;
-            return alloc;
-        }
+        allocator_type get_allocator() const { return mAllocator; }
 
+        // A coroutine parked in async_pop is resumed on the pushing thread before push returns
         void push(const Type &value) {
-            {
-                std::scoped_lock Guard { mMutex };
-                Internal_push(value);
-            }
+            Internal_push(value);
+            Notify_waiters();
         }
 
         void push(Type &&value) {
-            {
-                std::scoped_lock Guard { mMutex };
-                Internal_push(std::move(value));
-            }
+            Internal_push(std::move(value));
+            Notify_waiters();
+        }
+
+        // Constructs the element in its slot from args, nothing is built on the caller's stack
+        template < class... Args >
+        void emplace(Args &&...args) {
+            Internal_push(std::forward< Args >(args)...);
+            Notify_waiters();
+        }
+
+        // Claims the next slot and returns a handle to it, see slot_reservation
+        [[nodiscard]] slot_reservation reserve_slot() { return slot_reservation { *this }; }
+
+        // Pushes [first, last) in order, slots are reserved for the whole range at once
+        template < class InputIt >
+        requires(traits::legacy_input_iterator< InputIt >) void push_range(InputIt first, InputIt last) {
+            Push_range(first, last, traits::iterator_category< InputIt > {});
+            Notify_waiters();
         }
 
         bool try_pop(Type &dest) {
-            {
-                std::scoped_lock Guard { mMutex };
-                if (!mQueue) {
-                    dest = Type {};
-                    return false;
-                }
+            if (!Internal_Pop([&dest](Type &element) { dest = std::move(element); })) {
+                mStats.Count_failed_pop();
+                dest = Type {};
+                return false;
+            }
+            mStats.Count_pop();
+            return true;
+        }
 
-                if (mQueue->mCurrent == mQueue->mUsedBegin) {
-                    dest = Type {};
-                    return false;
-                }
+        // Moves the element straight out of its slot, no default constructed Type is needed
+        std::optional< Type > try_pop() {
+            std::optional< Type > result {};
+            if (Internal_Pop([&result](Type &element) { result.emplace(std::move(element)); })) {
+                mStats.Count_pop();
+            } else {
+                mStats.Count_failed_pop();
+            }
+            return result;
+        }
 
-                return Internal_Pop(dest);
+        // Moves up to max_count elements into dest, returns how many were popped
+        template < class OutputIt >
+        size_type try_pop_bulk(OutputIt dest, const size_type max_count) {
+            const auto popped = Internal_pop_bulk(dest, max_count);
+            if (popped != 0) {
+                mStats.Count_pop(popped);
+            } else {
+                mStats.Count_failed_pop();
             }
+            return popped;
         }
 
-        iterator unsafe_begin() { return iterator(this, mQueue, 0); }
+        // co_await queue.async_pop() yields the next element, or std::nullopt once the queue is closed and empty.
+        // The queue must outlive every coroutine parked on it
+        [[nodiscard]] pop_awaiter async_pop() noexcept { return pop_awaiter { *this }; }
+
+        // Resumes every parked consumer, with an element while there are some left and std::nullopt after that.
+        // Later async_pop calls still drain the queue but complete with std::nullopt instead of suspending.
+        void close() {
+            mClosed.store(true);
+            Resume_waiters(true);
+        }
 
-        const_iterator unsafe_begin() const { return iterator(this, 0); }
+        [[nodiscard]] bool is_closed() const noexcept { return mClosed.load(); }
+
+        iterator unsafe_begin() {
+            const auto queue = mQueue.load();
+            if (!queue) {
+                return iterator(this);
+            }
+
+            const auto [first_queue, first_idx] = Find_element(queue, Get_mini_queue_first(queue));
+            return iterator(this, first_queue, first_idx);
+        }
+
+        const_iterator unsafe_begin() const { return const_cast< concurrent_queue * >(this)->unsafe_begin(); }
 
         iterator unsafe_end() { return iterator(this); }
 
-        const_iterator unsafe_end() const { return iterator(this); }
+        const_iterator unsafe_end() const { return iterator(const_cast< concurrent_queue * >(this)); }
 
-        size_type unsafe_size() const {
-            auto queue = mQueue;
-            if (!queue) {
-                return static_cast< size_type >(0);
+        size_type unsafe_size() const { return Approximate_size(); }
+
+        // Concurrency-safe, the result may already be stale when concurrent pushes and pops are in flight
+        size_type size_hint() const {
+            Operation_guard guard { mReclaimer };
+            return Approximate_size();
+        }
+
+        void clear() { Destroy_all_elements(); }
+
+        // Not concurrency-safe. clear with the segments cut into pieces that executor tasks destroy and reset,
+        // the calling thread takes a share. Keeps the segments like clear, and is a plain clear below two pieces
+        // or without a second hardware thread
+        template < class Executor = async_executor >
+        void clear_parallel(Executor executor = Executor {}) {
+            std::vector< Clear_piece > pieces {};
+            if constexpr (!traits::is_trivially_destroyed_v< Allocator, Type >) {
+                if (std::thread::hardware_concurrency() > 1) {
+                    Collect_clear_pieces(pieces);
+                }
             }
 
-            size_type size = 0;
-            while (queue) {
-                size += Get_mini_queue_used_size(queue);
-                queue = queue->mNextQueue;
+            const auto task_count = std::min< std::size_t >(std::thread::hardware_concurrency(), pieces.size());
+            if (task_count <= 1) {
+                clear();
+                return;
+            }
+
+            impl::Run_chunks(executor, task_count, [this, &pieces, task_count](const std::size_t chunk) {
+                for (auto piece = chunk; piece < pieces.size(); piece += task_count) {
+                    Clear_piece_of_mini_queue(pieces[piece]);
+                }
+            });
+
+            for (auto queue = mQueue.load(); queue; queue = queue->mNextQueue.load()) {
+                queue->mPushTicket.store(0);
+                queue->mPopTicket.store(0);
             }
-            return size;
+            mQueueEnd.store(mQueue.load());
         }
 
-        void clear() { Destroy_all_elements(); }
+        /// <summary>
+        /// Not concurrency-safe. Detaches the segment chain in O(1) and hands it, with the elements still in it,
+        /// to one executor task that destroys and frees it, so the calling thread goes on at once with an empty
+        /// queue. Returns the executor's handle on that task. The future of async_executor waits for the task
+        /// when it is destroyed, keep it for as long as the caller should not block. If the task can not be
+        /// started the chain is destroyed on the calling thread and the exception is rethrown
+        /// </summary>
+        template < class Executor = async_executor >
+        [[nodiscard]] auto clear_deferred(Executor executor = Executor {}) {
+            auto detached = std::make_unique< concurrent_queue >(std::move(*this), mAllocator);
+
+            auto handle = executor([storage = detached.get()]() noexcept { delete storage; });
+            (void)detached.release();
+            return handle;
+        }
+
+        // Concurrency-safe, see container_stats for what is counted and how to enable it
+        [[nodiscard]] container_stats stats() const { return mStats.Snapshot(); }
 
 #ifndef CONCURRENT_QUEUE_DEVELOPER_DEBUG
       private:
 #endif // CONCURRENT_QUEUE_DEVELOPER_DEBUG
         template < class... Args >
         void Internal_push(Args &&...args) {
-            if (mQueueEnd == mQueueCurrent) {
-                if (!mQueue) {
-                    auto queue = Allocate_mini_queue(1, 0);
-                    Emplace_back_mini_queue(queue);
-                } else if (mQueueCurrent->mCurrent == mQueueCurrent->mEnd) {
-                    const auto size = unsafe_size();
+            Operation_guard guard { mReclaimer };
+            const auto [queue, ticket] = Claim_slot();
+            Construct_in_slot(queue, ticket, std::forward< Args >(args)...);
+            mStats.Count_push();
+        }
+
+        // Draws push tickets until one lands on an Empty slot and marks it Busy. Shall be used inside an
+        // Operation_guard, which has to last until the slot is published
+        std::pair< MiniQueue *, size_type > Claim_slot() {
+            for (;;) {
+                auto queue = mQueueEnd.load();
+                if (!queue) {
+                    Install_first_mini_queue();
+                    continue;
+                }
+
+                const auto capacity = Get_mini_queue_capacity(queue);
+                const auto ticket   = queue->mPushTicket.fetch_add(1);
+                if (ticket < capacity) {
+                    auto expected = Slot_state::Empty;
+                    if (!queue->mStates[ticket].compare_exchange_strong(expected, Slot_state::Busy,
+                                                                        std::memory_order_acquire)) {
+                        continue; // A consumer gave up on this slot before we got to it
+                    }
+                    return { queue, ticket };
+                }
+
+                Append_mini_queue(queue, ticket == capacity);
+            }
+        }
+
+        // consume is handed the popped element right before it is destroyed
+        template < class Consume >
+        bool Internal_Pop(Consume &&consume) {
+            Operation_guard guard { mReclaimer };
+            for (;;) {
+                auto queue = mQueue.load();
+                if (!queue) {
+                    return false;
+                }
+
+                const auto capacity   = Get_mini_queue_capacity(queue);
+                const auto pop_ticket = queue->mPopTicket.load();
+                if (pop_ticket >= capacity) {
+                    if (!Advance_mini_queue(queue)) {
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (pop_ticket >= queue->mPushTicket.load()) {
+                    return false;
+                }
+
+                const auto ticket = queue->mPopTicket.fetch_add(1);
+                if (ticket >= capacity) {
+                    continue;
+                }
+
+                if (!Acquire_slot(queue, ticket)) {
+                    continue;
+                }
+
+                const auto element = queue->mBegin + ticket;
+                try {
+                    consume(*element);
+                } catch (...) {
+                    Destroy_element(element);
+                    throw;
+                }
+                Destroy_element(element);
+                return true;
+            }
+        }
+
+        bool Pop_into(std::optional< Type > &result) {
+            if (!Internal_Pop([&result](Type &element) { result.emplace(std::move(element)); })) {
+                return false;
+            }
+            mStats.Count_pop();
+            return true;
+        }
+
+        /// <summary>
+        /// Parks a consumer unless an element or the close arrived meanwhile. The waiter count is raised before
+        /// the queue is checked again, and a producer reads it after drawing its ticket, both sequentially
+        /// consistent: either this check sees the element or that producer sees the waiter.
+        /// </summary>
+        bool Suspend_waiter(pop_awaiter &waiter, const std::coroutine_handle<> handle) {
+            std::scoped_lock guard { mWaitMutex };
+            mWaiterCount.fetch_add(1);
+            try {
+                if (Pop_into(waiter.mResult) || mClosed.load()) {
+                    mWaiterCount.fetch_sub(1);
+                    return false;
+                }
+            } catch (...) {
+                mWaiterCount.fetch_sub(1);
+                throw;
+            }
+
+            waiter.mHandle = handle;
+            (mWaitTail ? mWaitTail->mNext : mWaitHead) = &waiter;
+            mWaitTail                                  = &waiter;
+            return true;
+        }
+
+        void Notify_waiters() {
+            if (mWaiterCount.load() != 0) {
+                Resume_waiters(false);
+            }
+        }
+
+        // Hands elements to parked consumers in FIFO order and resumes them outside the lock. Unless closing,
+        // a waiter stays parked when another consumer took the element first
+        void Resume_waiters(const bool closing) {
+            for (;;) {
+                pop_awaiter *waiter = nullptr;
+                {
+                    std::scoped_lock guard { mWaitMutex };
+                    if (!mWaitHead || (!Pop_into(mWaitHead->mResult) && !closing)) {
+                        return;
+                    }
+
+                    waiter = std::exchange(mWaitHead, mWaitHead->mNext);
+                    if (!mWaitHead) {
+                        mWaitTail = nullptr;
+                    }
+                    mWaiterCount.fetch_sub(1);
+                }
+                waiter->mHandle.resume();
+            }
+        }
+
+        template < class InputIt >
+        void Push_range(InputIt first, InputIt last, std::input_iterator_tag) {
+            for (; first != last; ++first) {
+                Internal_push(*first);
+            }
+        }
 
-                    auto queue = Allocate_mini_queue(size + 1, size);
-                    Emplace_back_mini_queue(queue);
+        template < class ForwardIt >
+        void Push_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+            auto count = static_cast< size_type >(std::distance(first, last));
+            mStats.Count_push(count);
+
+            Operation_guard guard { mReclaimer };
+            while (count != 0) {
+                auto queue = mQueueEnd.load();
+                if (!queue) {
+                    Install_first_mini_queue();
+                    continue;
+                }
+
+                const auto capacity = Get_mini_queue_capacity(queue);
+                const auto ticket   = queue->mPushTicket.fetch_add(count);
+                const auto overflow = ticket + count > capacity;
+                if (ticket < capacity) {
+                    count -= Construct_in_slots(queue, ticket, std::min(ticket + count, capacity), first);
+                }
+
+                if (overflow) {
+                    Append_mini_queue(queue, ticket <= capacity);
                 }
             }
+        }
 
-            allocator_traits::construct(mAllocator, unfancy_ptr(mQueueCurrent->mCurrent),
-                                        std::forward< Args >(args)...);
-            mQueueCurrent->mCurrent++;
+        template < class OutputIt >
+        size_type Internal_pop_bulk(OutputIt &dest, const size_type max_count) {
+            Operation_guard guard { mReclaimer };
+            size_type       popped = 0;
+            while (popped < max_count) {
+                auto queue = mQueue.load();
+                if (!queue) {
+                    break;
+                }
+
+                const auto capacity   = Get_mini_queue_capacity(queue);
+                const auto pop_ticket = queue->mPopTicket.load();
+                if (pop_ticket >= capacity) {
+                    if (!Advance_mini_queue(queue)) {
+                        break;
+                    }
+                    continue;
+                }
+
+                const auto push_ticket = std::min(queue->mPushTicket.load(), capacity);
+                if (pop_ticket >= push_ticket) {
+                    break;
+                }
 
-            if (mQueueCurrent->mCurrent == mQueueCurrent->mEnd && mQueueCurrent != mQueueEnd) {
-                mQueueCurrent->mCurrent = mQueueCurrent->mNextQueue->mBegin;
-                mQueueCurrent           = mQueueCurrent->mNextQueue;
+                const auto wanted = std::min(push_ticket - pop_ticket, max_count - popped);
+                const auto ticket = queue->mPopTicket.fetch_add(wanted);
+                const auto last   = std::min(ticket + wanted, capacity);
+                for (auto idx = ticket; idx < last; ++idx) {
+                    if (!Acquire_slot(queue, idx)) {
+                        continue;
+                    }
+
+                    const auto element = queue->mBegin + idx;
+                    try {
+                        *dest = std::move(*element);
+                    } catch (...) {
+                        Destroy_element(element);
+                        Discard_slots(queue, idx + 1, last); // Nobody else will visit the rest of our tickets
+                        throw;
+                    }
+                    Destroy_element(element);
+                    ++dest;
+                    ++popped;
+                }
             }
+            return popped;
         }
 
-        bool Internal_Pop(Type &dest) {
-            dest = *mQueue->mUsedBegin;
-            allocator_traits::destroy(mAllocator, unfancy_ptr(mQueue->mUsedBegin));
-            mQueue->mUsedBegin++;
+        /// <summary>
+        /// Waits until the producer of a popped ticket is done with its slot,
+        /// returns false if the slot does not hold an element
+        /// </summary>
+        bool Acquire_slot(MiniQueue *queue, size_type idx) noexcept {
+            auto &state    = queue->mStates[idx];
+            auto  expected = Slot_state::Empty;
+            if (state.compare_exchange_strong(expected, Slot_state::Taken, std::memory_order_acquire)) {
+                return false; // The producer of this slot has not claimed it yet, it will draw another ticket
+            }
 
-            if (mQueue->mUsedBegin == mQueue->mEnd) {
-                mQueue->mUsedBegin = mQueue->mBegin;
-                mQueue->mCurrent   = mQueue->mBegin;
+            while (expected == Slot_state::Busy) { // The producer is in the middle of constructing the element
+                mStats.Count_contended_wait();
+                std::this_thread::yield();
+                expected = state.load(std::memory_order_acquire);
+            }
 
-                if (mQueue != mQueueEnd) {
-                    mQueueEnd->mNextQueue = mQueue;
-                    mQueueEnd             = mQueue;
-                    mQueue                = std::exchange(mQueue->mNextQueue, nullptr);
+            return expected == Slot_state::Ready;
+        }
+
+        void Discard_slots(MiniQueue *queue, size_type first, const size_type last) noexcept {
+            for (; first < last; ++first) {
+                if (Acquire_slot(queue, first)) {
+                    Destroy_element(queue->mBegin + first);
                 }
             }
+        }
+
+        /// <summary>
+        /// Claims the slots [first, last) and constructs consecutive elements of source into them,
+        /// slots poisoned by consumers are skipped. Returns how many elements were placed.
+        /// </summary>
+        template < class ForwardIt >
+        size_type Construct_in_slots(MiniQueue *queue, size_type first, const size_type last, ForwardIt &source) {
+            size_type placed = 0;
+            while (first < last) {
+                auto run_end = first;
+                for (; run_end < last; ++run_end) {
+                    auto expected = Slot_state::Empty;
+                    if (!queue->mStates[run_end].compare_exchange_strong(expected, Slot_state::Busy,
+                                                                         std::memory_order_acquire)) {
+                        break;
+                    }
+                }
+
+                Construct_run(queue, first, run_end, source);
+                placed += run_end - first;
+                first = run_end + 1;
+            }
+            return placed;
+        }
+
+        template < class Iter >
+        static constexpr bool Is_bitwise_copy_source =
+            std::contiguous_iterator< Iter > && std::is_same_v< std::iter_value_t< Iter >, Type > &&
+            traits::is_trivially_copy_constructed_v< Allocator, Type >;
+
+        template < class ForwardIt >
+        void Construct_run(MiniQueue *queue, const size_type first, const size_type last, ForwardIt &source) {
+            if constexpr (Is_bitwise_copy_source< ForwardIt >) { // Runs of consecutive slots are contiguous
+                if (first != last) {
+                    std::memcpy(queue->mBegin + first, std::to_address(source), (last - first) * sizeof(Type));
+                    source += static_cast< std::iter_difference_t< ForwardIt > >(last - first);
+                }
+                Publish_slots(queue, first, last, Slot_state::Ready);
+                return;
+            }
+
+            auto idx = first;
+            try {
+                for (; idx < last; ++idx, (void)++source) {
+                    allocator_traits::construct(mAllocator, unfancy_ptr(queue->mBegin + idx), *source);
+                }
+            } catch (...) {
+                Publish_slots(queue, first, idx, Slot_state::Ready);
+                Publish_slots(queue, idx, last, Slot_state::Taken);
+                throw;
+            }
+            Publish_slots(queue, first, last, Slot_state::Ready);
+        }
+
+        void Destroy_element(value_type *element) noexcept {
+            if constexpr (!traits::is_trivially_destroyed_v< Allocator, Type >) {
+                allocator_traits::destroy(mAllocator, unfancy_ptr(element));
+            }
+        }
+
+        void Publish_slots(MiniQueue *queue, size_type first, const size_type last, const Slot_state state) noexcept {
+            for (; first < last; ++first) {
+                queue->mStates[first].store(state, std::memory_order_release);
+            }
+        }
+
+        template < class... Args >
+        void Construct_in_slot(MiniQueue *queue, size_type idx, Args &&...args) {
+            auto &state = queue->mStates[idx];
+            try {
+                allocator_traits::construct(mAllocator, unfancy_ptr(queue->mBegin + idx),
+                                            std::forward< Args >(args)...);
+            } catch (...) {
+                state.store(Slot_state::Taken, std::memory_order_release);
+                throw;
+            }
+            state.store(Slot_state::Ready, std::memory_order_release);
+        }
+
+        void Install_first_mini_queue() {
+            auto new_queue = Allocate_mini_queue(1, 0);
+
+            MiniQueue *expected = nullptr;
+            if (mQueue.compare_exchange_strong(expected, new_queue)) {
+                mCapacity.fetch_add(Get_mini_queue_capacity(new_queue));
+            } else {
+                Deallocate_mini_queue(new_queue);
+                new_queue = expected;
+            }
+
+            expected = nullptr;
+            mQueueEnd.compare_exchange_strong(expected, new_queue);
+        }
+
+        /// <summary>
+        /// Links a successor to a full tail segment and moves the tail onto it. Only the producer that drew
+        /// the first overflowing ticket allocates right away, the others give it a chance to finish first.
+        /// </summary>
+        void Append_mini_queue(MiniQueue *queue, bool first_to_overflow) {
+            auto next = queue->mNextQueue.load();
+            if (!first_to_overflow) {
+                for (auto spin = 0; !next && spin < Append_spin_count; ++spin) {
+                    mStats.Count_contended_wait();
+                    std::this_thread::yield();
+                    next = queue->mNextQueue.load();
+                }
+            }
+
+            if (!next) {
+                const auto size      = Approximate_size();
+                auto       new_queue = Allocate_mini_queue(size + 1, size);
+                new_queue->mBase     = queue->mBase + Get_mini_queue_capacity(queue);
+                if (queue->mNextQueue.compare_exchange_strong(next, new_queue)) {
+                    mCapacity.fetch_add(Get_mini_queue_capacity(new_queue));
+                    next = new_queue;
+                } else {
+                    Recycle_mini_queue(new_queue);
+                }
+            }
+
+            mQueueEnd.compare_exchange_strong(queue, next);
+        }
+
+        /// <summary>
+        /// Moves the head past a fully consumed segment, returns false if there is nothing after it
+        /// </summary>
+        bool Advance_mini_queue(MiniQueue *queue) {
+            const auto next = queue->mNextQueue.load();
+            if (!next) {
+                return false;
+            }
+
+            auto tail = queue; // The tail must never lag behind the head
+            mQueueEnd.compare_exchange_strong(tail, next);
+
+            auto head = queue;
+            if (mQueue.compare_exchange_strong(head, next)) {
+                mCapacity.fetch_sub(Get_mini_queue_capacity(queue));
+                Retire_mini_queue(queue);
+            }
             return true;
         }
 
+        void Retire_mini_queue(MiniQueue *queue) const noexcept { mReclaimer.Retire(queue); }
+
         auto Get_mini_queue_size(const MiniQueue *const queue) const noexcept { // User shall guarantee no nullptr;
             assert(queue);
-            return static_cast< size_type >(queue->mCurrent - queue->mBegin);
+            return std::min(queue->mPushTicket.load(), Get_mini_queue_capacity(queue));
         }
 
         auto Get_mini_queue_capacity(const MiniQueue *const queue) const noexcept { // User shall guarantee no nullptr;
@@ -311,12 +918,22 @@ namespace concurrent {
             return static_cast< size_type >(queue->mEnd - queue->mBegin);
         }
 
+        /// <summary>
+        /// Index of the first slot not handed to a consumer yet
+        /// </summary>
+        auto Get_mini_queue_first(const MiniQueue *const queue) const noexcept { // User shall guarantee no nullptr;
+            assert(queue);
+            return std::min(queue->mPopTicket.load(), Get_mini_queue_capacity(queue));
+        }
+
         /// <summary>
         /// Shall be used on the first node
         /// </summary>
         auto Get_mini_queue_used_size(const MiniQueue *const queue) const noexcept { // User shall guarantee no nullptr;
             assert(queue);
-            return static_cast< size_type >(queue->mCurrent - queue->mUsedBegin);
+            const auto first = Get_mini_queue_first(queue);
+            const auto last  = Get_mini_queue_size(queue);
+            return static_cast< size_type >(last > first ? last - first : 0);
         }
 
         /// <summary>
@@ -325,165 +942,245 @@ namespace concurrent {
         auto Get_mini_queue_used_capacity(
             const MiniQueue *const queue) const noexcept { // User shall guarantee no nullptr;
             assert(queue);
-            return static_cast< size_type >(queue->mEnd - queue->mUsedBegin);
+            return static_cast< size_type >(Get_mini_queue_capacity(queue) - Get_mini_queue_first(queue));
         }
 
-        size_type Unsafe_capacity() const noexcept {
-            auto queue = mQueue;
-            if (!queue) {
+        /// <summary>
+        /// Slots pushed minus slots popped over the lifetime of the queue. The head is read before the tail,
+        /// the tail never lags behind the head so the result can not underflow.
+        /// Shall be used inside an Operation_guard when called concurrently.
+        /// </summary>
+        size_type Approximate_size() const noexcept {
+            const auto head = mQueue.load();
+            const auto tail = mQueueEnd.load();
+            if (!head || !tail) {
                 return static_cast< size_type >(0);
             }
 
-            size_type capacity = 0;
-            while (queue) {
-                capacity += Get_mini_queue_used_capacity(queue);
-                queue = queue->mNextQueue;
+            const auto popped = head->mBase + Get_mini_queue_first(head);
+            const auto pushed = tail->mBase + Get_mini_queue_size(tail);
+            return static_cast< size_type >(pushed > popped ? pushed - popped : 0);
+        }
+
+        size_type Unsafe_capacity() const noexcept {
+            const auto head = mQueue.load();
+            if (!head) {
+                return static_cast< size_type >(0);
             }
 
-            return capacity;
+            return static_cast< size_type >(mCapacity.load() - Get_mini_queue_first(head));
         }
 
-        auto Unsafe_size_and_capacity() const noexcept {
-            auto      queue    = mQueue;
-            size_type capacity = 0;
-            size_type size     = 0;
-            if (!queue) {
-                return std::make_pair(size, capacity);
-            }
+        auto Unsafe_size_and_capacity() const noexcept { return std::make_pair(Approximate_size(), Unsafe_capacity()); }
 
+        void Destroy_all_elements() {
+            auto queue = mQueue.load();
             while (queue) {
-                capacity += Get_mini_queue_used_capacity(queue);
-                size += Get_mini_queue_used_size(queue);
-                queue = queue->mNextQueue;
+                Destroy_all_element_in_mini_queue(queue);
+                Reset_mini_queue(queue);
+                queue = queue->mNextQueue.load();
             }
-            return std::make_pair(size, capacity);
+            mQueueEnd.store(mQueue.load());
         }
 
-        void Emplace_back_mini_queue(MiniQueue *queue) {
-            if (!mQueue) {
-                mQueue        = queue;
-                mQueueCurrent = queue;
-                mQueueEnd     = queue;
-
-                return;
+        void Destroy_all_element_in_mini_queue(MiniQueue *queue) {
+            if constexpr (traits::is_trivially_destroyed_v< Allocator, Type >) {
+                return; // Nothing to run, the slot states are reset by the caller
             }
 
-            mQueueEnd->mNextQueue = queue;
-            mQueueEnd             = queue;
-
-            if (mQueueCurrent->mCurrent == mQueueCurrent->mEnd) {
-                mQueueCurrent = mQueueCurrent->mNextQueue;
+            const auto last = Get_mini_queue_size(queue);
+            for (auto i = Get_mini_queue_first(queue); i < last; ++i) {
+                if (queue->mStates[i].load(std::memory_order_acquire) == Slot_state::Ready) {
+                    Destroy_element(queue->mBegin + i);
+                }
             }
         }
 
-        template < class Func >
-        void Apply_for_each_element_front_to_back(Func &&func) noexcept(
-            std::declval< Func >()(std::declval< Type * >())) {
-            auto queue = mQueue;
-            while (queue) {
-                const auto size = Get_mini_queue_size(queue);
-                for (auto i = 0; i < size; ++i) {
-                    func(&(queue->mElements[i]));
+        // Slots [mFirst, mLast) of one segment, a share of the work of clear_parallel
+        struct Clear_piece {
+            MiniQueue *mQueue;
+            size_type  mFirst;
+            size_type  mLast;
+        };
+
+        void Collect_clear_pieces(std::vector< Clear_piece > &pieces) const {
+            for (auto queue = mQueue.load(); queue; queue = queue->mNextQueue.load()) {
+                const auto capacity = Get_mini_queue_capacity(queue);
+                for (size_type first = 0; first < capacity; first += Parallel_clear_grain) {
+                    pieces.push_back(Clear_piece { queue, first, std::min(capacity, first + Parallel_clear_grain) });
                 }
-                queue = queue->mNextQueue;
             }
         }
 
-        template < class Func, class... Args >
-        void Apply_for_each_element_front_to_back(Func &&func, Args &&...args) const
-            noexcept(std::declval< Func >()(std::declval< Args >()...)) {
-            auto queue = mQueue;
-            while (queue) {
-                const auto size = Get_mini_queue_size(queue);
-                for (auto i = 0; i < size; ++i) {
-                    func(args...);
+        // Destroys the elements left in the piece and marks all of its slots Empty
+        void Clear_piece_of_mini_queue(const Clear_piece &piece) noexcept {
+            const auto queue = piece.mQueue;
+            const auto first = std::max(piece.mFirst, Get_mini_queue_first(queue));
+            const auto last  = std::min(piece.mLast, Get_mini_queue_size(queue));
+            for (auto i = first; i < last; ++i) {
+                if (queue->mStates[i].load(std::memory_order_acquire) == Slot_state::Ready) {
+                    Destroy_element(queue->mBegin + i);
                 }
-                queue = queue->mNextQueue;
+            }
+            for (auto i = piece.mFirst; i < piece.mLast; ++i) {
+                queue->mStates[i].store(Slot_state::Empty, std::memory_order_relaxed);
             }
         }
 
-        void Destroy_all_elements() {
-            auto queue = mQueue;
-            while (queue) {
-                Destroy_all_elements_in_mini_queue(queue);
-                queue->mCurrent   = queue->mBegin;
-                queue->mUsedBegin = queue->mBegin;
-                queue             = queue->mNextQueue;
+        void Reset_mini_queue(MiniQueue *queue) noexcept {
+            const auto capacity = Get_mini_queue_capacity(queue);
+            for (size_type i = 0; i < capacity; ++i) {
+                queue->mStates[i].store(Slot_state::Empty, std::memory_order_relaxed);
             }
-            mQueueCurrent = mQueue;
+            queue->mPushTicket.store(0);
+            queue->mPopTicket.store(0);
         }
 
-        void Destroy_all_element_in_mini_queue(MiniQueue *queue) {
-            for (auto i = queue->mUsedBegin; i < queue->mCurrent; ++i) {
-                allocator_traits::destroy(mAllocator, i);
+        /// <summary>
+        /// Returns the first constructed element at or after element_idx
+        /// </summary>
+        std::pair< MiniQueue *, size_type > Find_element(MiniQueue *queue, size_type element_idx) const noexcept {
+            while (queue) {
+                const auto last = Get_mini_queue_size(queue);
+                for (; element_idx < last; ++element_idx) {
+                    if (queue->mStates[element_idx].load(std::memory_order_acquire) == Slot_state::Ready) {
+                        return std::make_pair(queue, element_idx);
+                    }
+                }
+
+                queue = queue->mNextQueue.load();
+                if (queue) {
+                    element_idx = Get_mini_queue_first(queue);
+                }
             }
+
+            return std::make_pair(nullptr, 0);
         }
 
         std::pair< MiniQueue *, size_type > Advance(MiniQueue *output_queue, size_type element_idx) const noexcept {
-            const auto current_queue_size     = Get_mini_queue_size(output_queue);
-            const auto current_queue_capacity = Get_mini_queue_capacity(output_queue);
+            return Find_element(output_queue, element_idx + 1);
+        }
 
-            if (current_queue_size == 0 && element_idx != current_queue_capacity - 1) {
-                return std::make_pair(nullptr, 0);
+        void Finalise() {
+            auto queue = mQueue.exchange(nullptr);
+            while (queue) {
+                auto to_delete = queue;
+                queue          = queue->mNextQueue.load();
+                Destroy_all_element_in_mini_queue(to_delete);
+                Deallocate_mini_queue(to_delete);
             }
+            mQueueEnd.store(nullptr);
+            mCapacity.store(0);
 
-            if (element_idx < current_queue_size - 1) {
-                return std::make_pair(output_queue, element_idx + 1);
-            }
+            mReclaimer.Drain();
 
-            const bool last_queue_element = element_idx == current_queue_size - 1;
-            if (last_queue_element && current_queue_size < current_queue_capacity) {
-                // last element in queue, and queue is not full.
-                return std::make_pair(nullptr, 0);
+            if (auto spare = mSpareQueue.exchange(nullptr)) {
+                Deallocate_mini_queue(spare);
             }
+        }
 
-            if (last_queue_element && output_queue->mNextQueue == nullptr) {
-                // last element in queue, queue is full, and no other queues.
-                return std::make_pair(nullptr, 0);
+        /// <summary>
+        /// Parks an unreachable segment for the next Allocate_mini_queue, so under steady traffic a drained
+        /// segment is handed straight to the producer that overflows the tail instead of going back to the
+        /// allocator. Only one segment is kept, any other is deallocated.
+        /// </summary>
+        void Recycle_mini_queue(MiniQueue *queue) const noexcept {
+            MiniQueue *expected = nullptr;
+            if (!mSpareQueue.compare_exchange_strong(expected, queue)) {
+                Deallocate_mini_queue(queue);
             }
+        }
 
-            auto       next_queue      = output_queue->mNextQueue;
-            const auto next_queue_size = Get_mini_queue_size(output_queue);
-            if (next_queue_size == 0) {
-                return std::make_pair(nullptr, 0);
+        // Takes the parked segment if it holds at least new_size slots without wasting more than half of it
+        MiniQueue *Take_spare_mini_queue(const size_type new_size) const noexcept {
+            auto spare = mSpareQueue.exchange(nullptr);
+            if (!spare) {
+                return nullptr;
             }
 
-            return std::make_pair(next_queue, 0);
-        }
+            const auto capacity = Get_mini_queue_capacity(spare);
+            if (capacity < new_size || capacity / 2 > new_size) {
+                Deallocate_mini_queue(spare);
+                return nullptr;
+            }
 
-        void Finalise() {
-            auto queue = mQueue;
-            while (queue) {
-                auto to_delete = queue;
-                queue          = queue->mNextQueue;
-                Destroy_all_element_in_mini_queue(to_delete);
-                Deallocate_mini_queue(to_delete);
+            for (size_type i = 0; i < capacity; ++i) {
+                spare->mStates[i].store(Slot_state::Empty, std::memory_order_relaxed);
             }
+            spare->mBase = 0;
+            spare->mNextQueue.store(nullptr, std::memory_order_relaxed);
+            spare->mRetiredNext = nullptr;
+            spare->mPushTicket.store(0, std::memory_order_relaxed);
+            spare->mPopTicket.store(0, std::memory_order_relaxed);
+            return spare;
         }
 
         MiniQueue *Allocate_mini_queue(size_type requested_new_size, size_type current_size) {
             auto new_capacity = Calculate_new_capacity(requested_new_size);
-            auto new_size     = std::max(Min_queue_size, new_capacity - current_size);
+            auto new_size     = segment_sizing::Segment_size(new_capacity - current_size);
 
-            auto alloc = mini_queue_allocator {};
-            auto queue = alloc.allocate(1);
+            if (auto spare = Take_spare_mini_queue(new_size)) {
+                mStats.Count_recycle();
+                return spare; // Published to other threads by the CAS that links it
+            }
 
+            auto alloc = mini_queue_allocator { mAllocator };
+            auto queue = alloc.allocate(1);
             mini_queue_allocator_traits::construct(alloc, queue);
-            queue->mElements  = mAllocator.allocate(new_size);
-            queue->mBegin     = queue->mElements;
-            queue->mUsedBegin = queue->mBegin;
-            queue->mCurrent   = queue->mBegin;
-            queue->mEnd       = queue->mBegin + new_size;
 
+            auto state_alloc = slot_state_allocator { mAllocator };
+            try {
+                queue->mBegin = mAllocator.allocate(new_size);
+                queue->mEnd   = queue->mBegin + new_size;
+
+                queue->mStates = state_alloc.allocate(new_size);
+            } catch (...) {
+                if (queue->mBegin) {
+                    mAllocator.deallocate(queue->mBegin, new_size);
+                }
+                mini_queue_allocator_traits::destroy(alloc, queue);
+                alloc.deallocate(queue, 1);
+                throw;
+            }
+
+            for (size_type i = 0; i < new_size; ++i) {
+                slot_state_allocator_traits::construct(state_alloc, queue->mStates + i, Slot_state::Empty);
+            }
+
+            mStats.Count_allocation(Mini_queue_bytes(new_size));
             return queue;
         }
 
-        void Deallocate_mini_queue(MiniQueue *queue) {
+        [[nodiscard]] static constexpr std::size_t Mini_queue_bytes(const size_type capacity) noexcept {
+            return sizeof(MiniQueue) + capacity * (sizeof(Type) + sizeof(slot_state));
+        }
+
+        // The linked segments and the spare, segments waiting on the reclaimer are not counted
+        [[nodiscard]] std::size_t Held_bytes() const noexcept {
+            auto bytes = std::size_t { 0 };
+            for (auto queue = mQueue.load(); queue; queue = queue->mNextQueue.load()) {
+                bytes += Mini_queue_bytes(Get_mini_queue_capacity(queue));
+            }
+            if (const auto spare = mSpareQueue.load()) {
+                bytes += Mini_queue_bytes(Get_mini_queue_capacity(spare));
+            }
+            return bytes;
+        }
+
+        void Deallocate_mini_queue(MiniQueue *queue) const noexcept {
             const auto queue_size = Get_mini_queue_capacity(queue);
+            mStats.Count_release(Mini_queue_bytes(queue_size));
+
+            auto state_alloc = slot_state_allocator { mAllocator };
+            for (size_type i = 0; i < queue_size; ++i) {
+                slot_state_allocator_traits::destroy(state_alloc, queue->mStates + i);
+            }
+            state_alloc.deallocate(queue->mStates, queue_size);
 
-            mAllocator.deallocate(queue->mBegin, queue_size);
+            auto element_alloc = mAllocator;
+            element_alloc.deallocate(queue->mBegin, queue_size);
 
-            auto alloc = mini_queue_allocator {};
+            auto alloc = mini_queue_allocator { mAllocator };
             mini_queue_allocator_traits::destroy(alloc, queue);
             alloc.deallocate(queue, 1);
         }
@@ -493,32 +1190,27 @@ namespace concurrent {
         }
 
         [[nodiscard]] inline static constexpr auto Calculate_new_capacity(const size_type new_size) noexcept {
-            // Geometry growth MSVC's vector algorithm
-            constexpr const auto size_limit = max_size();
-            const auto           current_capacity =
-                new_size - 1; // Queue would allocate if and only if an element is pushed when it's full
-
-            if (current_capacity > size_limit - current_capacity / 2) {
-                return std::max(Min_queue_size, size_limit);
-            }
-
-            const size_type Size = current_capacity + current_capacity / 2;
+            return segment_sizing::New_capacity(new_size);
+        }
 
-            if (Size < new_size) {
-                return std::max(Min_queue_size, new_size);
-            }
+        std::atomic< MiniQueue * > mQueue { nullptr };
+        std::atomic< MiniQueue * > mQueueEnd { nullptr };
 
-            return std::max(Min_queue_size, Size);
-        }
+        mutable std::atomic< MiniQueue * > mSpareQueue { nullptr };
+        std::atomic< size_type >           mCapacity { 0 }; // Slots in the linked segments
+        epoch_reclaimer                    mReclaimer { Mini_queue_recycler { this } };
 
-        MiniQueue *mQueue { nullptr };
-        MiniQueue *mQueueCurrent { nullptr };
-        MiniQueue *mQueueEnd { nullptr };
+        // Consumers parked in async_pop, only touched by the slow path of push once mWaiterCount is raised
+        std::mutex               mWaitMutex {};
+        pop_awaiter *            mWaitHead { nullptr };
+        pop_awaiter *            mWaitTail { nullptr };
+        std::atomic< size_type > mWaiterCount { 0 };
+        std::atomic< bool >      mClosed { false };
 
-        allocator_type     mAllocator {};
-        mutable std::mutex mMutex {};
+        allocator_type                             mAllocator {};
+        [[no_unique_address]] impl::Stats_recorder mStats {};
     };
 
 } // namespace concurrent
 
-#endif // CONCURRENT_QUEUE_HPP
\ No newline at end of file
+#endif // CONCURRENT_QUEUE_HPP
@@ -0,0 +1,598 @@
+#ifndef CONCURRENT_UNORDERED_BASE_HPP
+#define CONCURRENT_UNORDERED_BASE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <utils.h>
+
+namespace concurrent {
+
+    namespace impl {
+        // Split-ordered list node. Bucket dummies have an even order key, element nodes an odd one.
+        template < class SizeType >
+        struct Split_node {
+            explicit Split_node(const SizeType order_key) noexcept : mOrderKey(order_key) {}
+
+            [[nodiscard]] bool Is_dummy() const noexcept { return (mOrderKey & 1) == 0; }
+
+            std::atomic< Split_node * > mNext { nullptr };
+            SizeType                    mOrderKey;
+        };
+
+        template < class Value, class SizeType >
+        struct Split_value_node : Split_node< SizeType > {
+            template < class... Args >
+            explicit Split_value_node(Args &&...args) :
+                Split_node< SizeType >(1), mValue(std::forward< Args >(args)...) {}
+
+            Value mValue;
+        };
+    } // namespace impl
+
+    template < class Value, class SizeType, bool IsConst >
+    struct concurrent_unordered_iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Value;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t< IsConst, const Value *, Value * >;
+        using reference         = std::conditional_t< IsConst, const Value &, Value & >;
+
+      private:
+        using node       = impl::Split_node< SizeType >;
+        using value_node = impl::Split_value_node< Value, SizeType >;
+
+        template < class Key, class TValue, class KeyOf, class Hash, class KeyEqual, class Allocator >
+        friend class concurrent_unordered_base;
+
+        template < class TValue, class TSizeType, bool TIsConst >
+        friend struct concurrent_unordered_iterator;
+
+      public:
+        constexpr concurrent_unordered_iterator() noexcept = default;
+
+        constexpr explicit concurrent_unordered_iterator(node *current) noexcept : mNode(current) {}
+
+        // iterator converts to const_iterator
+        template < bool OtherConst >
+        requires(IsConst && !OtherConst) constexpr concurrent_unordered_iterator(
+            const concurrent_unordered_iterator< Value, SizeType, OtherConst > &other) noexcept :
+            mNode(other.mNode) {}
+
+        [[nodiscard]] reference operator*() const noexcept { return static_cast< value_node * >(mNode)->mValue; }
+        [[nodiscard]] pointer   operator->() const noexcept { return std::addressof(operator*()); }
+
+        concurrent_unordered_iterator &operator++() noexcept {
+            mNode = Next_element(mNode);
+            return *this;
+        }
+        concurrent_unordered_iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        [[nodiscard]] constexpr bool operator==(const concurrent_unordered_iterator &rhs) const noexcept {
+            return mNode == rhs.mNode;
+        }
+
+      private:
+        // Skips bucket dummies, ends on nullptr
+        [[nodiscard]] static node *Next_element(node *current) noexcept {
+            do {
+                current = current->mNext.load(std::memory_order_acquire);
+            } while (current && current->Is_dummy());
+            return current;
+        }
+
+        node *mNode { nullptr };
+    };
+
+    /// <summary>
+    /// Hash table shared by concurrent_unordered_map and concurrent_unordered_set, after Shalev and Shavit's
+    /// split-ordered lists. All elements sit in one lock-free linked list sorted by their bit-reversed hash,
+    /// every bucket is a dummy node pointing into it. Doubling the bucket count only splits buckets in place,
+    /// new buckets get their dummy on first use, so rehashing never stops the world. Insertion, lookup and
+    /// iteration are concurrency-safe with each other, erasure is not (unsafe_erase), so no node is unlinked
+    /// while anyone could be reading it.
+    /// </summary>
+    template < class Key, class Value, class KeyOf, class Hash, class KeyEqual, class Allocator >
+    class concurrent_unordered_base {
+        static_assert(std::is_same_v< Value, typename Allocator::value_type >,
+                      "concurrent unordered containers require their allocator type to match value_type");
+
+      protected:
+        using allocator_traits = std::allocator_traits< Allocator >;
+
+      public:
+        using key_type        = Key;
+        using value_type      = Value;
+        using hasher          = Hash;
+        using key_equal       = KeyEqual;
+        using allocator_type  = Allocator;
+        using size_type       = typename allocator_traits::size_type;
+        using difference_type = typename allocator_traits::difference_type;
+        using reference       = Value &;
+        using const_reference = const Value &;
+        using pointer         = typename allocator_traits::pointer;
+        using const_pointer   = typename allocator_traits::const_pointer;
+
+        // A set stores its keys as the values, writing through an iterator would move an element off its hash
+        // position in the list, so both iterators are const there like std::unordered_set's
+        using iterator       = concurrent_unordered_iterator< Value, size_type, std::is_same_v< Key, Value > >;
+        using const_iterator = concurrent_unordered_iterator< Value, size_type, true >;
+
+      protected:
+        using node       = impl::Split_node< size_type >;
+        using value_node = impl::Split_value_node< Value, size_type >;
+        using bucket     = std::atomic< node * >;
+
+        using node_allocator              = typename allocator_traits::template rebind_alloc< node >;
+        using node_allocator_traits       = std::allocator_traits< node_allocator >;
+        using value_node_allocator        = typename allocator_traits::template rebind_alloc< value_node >;
+        using value_node_allocator_traits = std::allocator_traits< value_node_allocator >;
+        using bucket_allocator            = typename allocator_traits::template rebind_alloc< bucket >;
+        using bucket_allocator_traits     = std::allocator_traits< bucket_allocator >;
+
+        static_assert(std::numeric_limits< size_type >::digits <= 64, "order keys are reversed as 64-bit words");
+
+        // The bucket array grows like concurrent_vector's segment table: segment 0 holds the buckets
+        // [0, Min_bucket_count), every following segment doubles the buckets before it
+        static constexpr size_type Min_bucket_count  = 8;
+        static constexpr size_type Segment_shift     = static_cast< size_type >(std::countr_zero(Min_bucket_count));
+        static constexpr size_type Max_bucket_count  = static_cast< size_type >(1)
+                                                      << (std::numeric_limits< size_type >::digits - 1);
+        static constexpr size_type Max_segment_count = std::numeric_limits< size_type >::digits - Segment_shift;
+
+        static constexpr float Default_max_load_factor = 4.0f;
+
+      public:
+        explicit concurrent_unordered_base(const size_type bucket_count = Min_bucket_count,
+                                           const hasher &hash = hasher {}, const key_equal &equal = key_equal {},
+                                           const allocator_type &allocator = allocator_type {}) :
+            mBucketCount(Initial_bucket_count(bucket_count)),
+            mHash(hash), mEqual(equal), mAllocator(allocator) {
+            Initialise();
+        }
+
+        explicit concurrent_unordered_base(const allocator_type &allocator) :
+            concurrent_unordered_base(Min_bucket_count, hasher {}, key_equal {}, allocator) {}
+
+        concurrent_unordered_base(const concurrent_unordered_base &rhs) :
+            concurrent_unordered_base(rhs.unsafe_bucket_count(), rhs.mHash, rhs.mEqual,
+                                      allocator_traits::select_on_container_copy_construction(rhs.mAllocator)) {
+            mMaxLoadFactor.store(rhs.max_load_factor());
+            insert(rhs.begin(), rhs.end());
+        }
+
+        // The moved-from table is left empty, it needs a fresh bucket 0 so this may allocate
+        concurrent_unordered_base(concurrent_unordered_base &&rhs) :
+            concurrent_unordered_base(Min_bucket_count, rhs.mHash, rhs.mEqual, rhs.mAllocator) {
+            swap(rhs);
+        }
+
+        // Not concurrency-safe
+        concurrent_unordered_base &operator=(concurrent_unordered_base rhs) {
+            swap(rhs);
+            return *this;
+        }
+
+        ~concurrent_unordered_base() { Finalise(); }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept { return mAllocator; }
+
+        [[nodiscard]] hasher hash_function() const { return mHash; }
+
+        [[nodiscard]] key_equal key_eq() const { return mEqual; }
+
+        /// Iterators - concurrency-safe, elements inserted meanwhile may or may not be visited
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        [[nodiscard]] iterator begin() noexcept { return iterator { First_element() }; }
+
+        [[nodiscard]] const_iterator begin() const noexcept { return const_iterator { First_element() }; }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+
+        [[nodiscard]] iterator end() noexcept { return iterator {}; }
+
+        [[nodiscard]] const_iterator end() const noexcept { return const_iterator {}; }
+
+        [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+        /// Capacity - concurrency-safe
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+        [[nodiscard]] size_type size() const noexcept { return mSize.load(); }
+
+        [[nodiscard]] size_type max_size() const noexcept {
+            return static_cast< size_type >(std::numeric_limits< size_type >::max());
+        }
+
+        /// Modifiers - concurrency-safe unless marked unsafe
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        std::pair< iterator, bool > insert(const value_type &value) { return emplace(value); }
+
+        std::pair< iterator, bool > insert(value_type &&value) { return emplace(std::move(value)); }
+
+        template < class InputIt >
+        requires(traits::legacy_input_iterator< InputIt >) void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                emplace(*first);
+            }
+        }
+
+        void insert(std::initializer_list< value_type > values) { insert(values.begin(), values.end()); }
+
+        // Builds the element first, it is destroyed again if the key is already present
+        template < class... Args >
+        std::pair< iterator, bool > emplace(Args &&...args) {
+            const auto new_node = Create_value_node(std::forward< Args >(args)...);
+            const auto hash     = mHash(KeyOf {}(new_node->mValue));
+            new_node->mOrderKey = Regular_key(hash);
+
+            const auto [found, inserted] = Insert_node< false >(Get_bucket(Bucket_of(hash)), new_node);
+            if (!inserted) {
+                Destroy_value_node(new_node);
+                return { iterator { found }, false };
+            }
+
+            Grow_if_overloaded(mSize.fetch_add(1) + 1);
+            return { iterator { new_node }, true };
+        }
+
+        // Not concurrency-safe
+        size_type unsafe_erase(const key_type &key) {
+            const auto hash = mHash(key);
+            return Unlink_if(Get_bucket(Bucket_of(hash)), Regular_key(hash),
+                             [this, &key](node *candidate) { return mEqual(Key_of(candidate), key); });
+        }
+
+        // Not concurrency-safe, returns the iterator following the erased element
+        iterator unsafe_erase(const_iterator position) {
+            const auto target = position.mNode;
+            const auto next   = iterator::Next_element(target);
+            Unlink_if(Get_bucket(Bucket_of(mHash(Key_of(target)))), target->mOrderKey,
+                      [target](node *candidate) { return candidate == target; });
+            return iterator { next };
+        }
+
+        // Not concurrency-safe
+        void clear() {
+            Finalise();
+            Initialise();
+        }
+
+        // Not concurrency-safe
+        void swap(concurrent_unordered_base &rhs) noexcept {
+            if (this == std::addressof(rhs)) {
+                return;
+            }
+
+            for (size_type segment = 0; segment < Max_segment_count; ++segment) {
+                mSegments[segment].store(rhs.mSegments[segment].exchange(mSegments[segment].load()));
+            }
+            mBucketCount.store(rhs.mBucketCount.exchange(mBucketCount.load()));
+            mSize.store(rhs.mSize.exchange(mSize.load()));
+            mMaxLoadFactor.store(rhs.mMaxLoadFactor.exchange(mMaxLoadFactor.load()));
+            std::swap(mHead, rhs.mHead);
+            std::swap(mHash, rhs.mHash);
+            std::swap(mEqual, rhs.mEqual);
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                std::swap(mAllocator, rhs.mAllocator);
+            }
+        }
+
+        /// Lookup - concurrency-safe and lock-free
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        [[nodiscard]] iterator find(const key_type &key) { return iterator { Find_node(key) }; }
+
+        [[nodiscard]] const_iterator find(const key_type &key) const { return const_iterator { Find_node(key) }; }
+
+        [[nodiscard]] size_type count(const key_type &key) const { return Find_node(key) ? 1 : 0; }
+
+        [[nodiscard]] bool contains(const key_type &key) const { return Find_node(key) != nullptr; }
+
+        [[nodiscard]] std::pair< iterator, iterator > equal_range(const key_type &key) {
+            const auto found = find(key);
+            return { found, found == end() ? found : std::next(found) };
+        }
+
+        [[nodiscard]] std::pair< const_iterator, const_iterator > equal_range(const key_type &key) const {
+            const auto found = find(key);
+            return { found, found == end() ? found : std::next(found) };
+        }
+
+        /// Hash policy - concurrency-safe
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        [[nodiscard]] size_type unsafe_bucket_count() const noexcept { return mBucketCount.load(); }
+
+        [[nodiscard]] size_type unsafe_max_bucket_count() const noexcept { return Max_bucket_count; }
+
+        [[nodiscard]] float load_factor() const noexcept {
+            return static_cast< float >(size()) / static_cast< float >(unsafe_bucket_count());
+        }
+
+        [[nodiscard]] float max_load_factor() const noexcept { return mMaxLoadFactor.load(); }
+
+        void max_load_factor(const float factor) {
+            if (!(factor > 0.0f)) {
+                throw std::out_of_range("invalid concurrent unordered container load factor");
+            }
+            mMaxLoadFactor.store(factor);
+        }
+
+        // Raises the bucket count to at least bucket_count, existing buckets split lazily as they are used
+        void rehash(const size_type bucket_count) {
+            const auto wanted  = Initial_bucket_count(bucket_count);
+            auto       current = mBucketCount.load();
+            while (current < wanted && !mBucketCount.compare_exchange_weak(current, wanted)) {
+            }
+        }
+
+      protected:
+        [[nodiscard]] static const key_type &Key_of(node *element) noexcept {
+            return KeyOf {}(static_cast< value_node * >(element)->mValue);
+        }
+
+        [[nodiscard]] node *Find_node(const key_type &key) const {
+            const auto hash      = mHash(key);
+            const auto order_key = Regular_key(hash);
+
+            auto current = Get_bucket(Bucket_of(hash))->mNext.load(std::memory_order_acquire);
+            while (current && current->mOrderKey < order_key) {
+                current = current->mNext.load(std::memory_order_acquire);
+            }
+            for (; current && current->mOrderKey == order_key;
+                 current = current->mNext.load(std::memory_order_acquire)) {
+                if (mEqual(Key_of(current), key)) {
+                    return current;
+                }
+            }
+            return nullptr;
+        }
+
+      private:
+        [[nodiscard]] static constexpr size_type Initial_bucket_count(const size_type bucket_count) noexcept {
+            return std::bit_ceil(std::clamp(bucket_count, Min_bucket_count, Max_bucket_count));
+        }
+
+        [[nodiscard]] static constexpr size_type Reverse_bits(const size_type value) noexcept {
+            auto bits = static_cast< std::uint64_t >(value);
+            bits      = (bits >> 1 & 0x5555555555555555ULL) | (bits & 0x5555555555555555ULL) << 1;
+            bits      = (bits >> 2 & 0x3333333333333333ULL) | (bits & 0x3333333333333333ULL) << 2;
+            bits      = (bits >> 4 & 0x0F0F0F0F0F0F0F0FULL) | (bits & 0x0F0F0F0F0F0F0F0FULL) << 4;
+            bits      = (bits >> 8 & 0x00FF00FF00FF00FFULL) | (bits & 0x00FF00FF00FF00FFULL) << 8;
+            bits      = (bits >> 16 & 0x0000FFFF0000FFFFULL) | (bits & 0x0000FFFF0000FFFFULL) << 16;
+            bits      = bits >> 32 | bits << 32;
+            return static_cast< size_type >(bits >> (64 - std::numeric_limits< size_type >::digits));
+        }
+
+        // Elements of bucket b all sort after b's dummy and before the dummy of the next bucket in split order
+        [[nodiscard]] static constexpr size_type Regular_key(const size_type hash) noexcept {
+            return Reverse_bits(hash) | 1;
+        }
+
+        [[nodiscard]] static constexpr size_type Dummy_key(const size_type bucket) noexcept {
+            return Reverse_bits(bucket);
+        }
+
+        [[nodiscard]] size_type Bucket_of(const size_type hash) const noexcept {
+            return hash & (mBucketCount.load() - 1);
+        }
+
+        [[nodiscard]] static constexpr size_type Segment_index_of(const size_type bucket) noexcept {
+            return static_cast< size_type >(std::bit_width(bucket >> Segment_shift));
+        }
+
+        [[nodiscard]] static constexpr size_type Segment_base(const size_type segment) noexcept {
+            return (static_cast< size_type >(1) << segment) >> 1 << Segment_shift;
+        }
+
+        [[nodiscard]] static constexpr size_type Segment_size(const size_type segment) noexcept {
+            return segment == 0 ? Min_bucket_count : Segment_base(segment);
+        }
+
+        // Returns the slot of a bucket, installing its segment if no other thread has yet
+        [[nodiscard]] bucket &Bucket_slot(const size_type bucket_index) const {
+            const auto segment = Segment_index_of(bucket_index);
+            auto       current = mSegments[segment].load(std::memory_order_acquire);
+            if (!current) {
+                auto       alloc    = bucket_allocator { mAllocator };
+                const auto new_size = Segment_size(segment);
+                const auto buckets  = alloc.allocate(new_size);
+                for (size_type i = 0; i < new_size; ++i) {
+                    bucket_allocator_traits::construct(alloc, buckets + i, nullptr);
+                }
+
+                if (mSegments[segment].compare_exchange_strong(current, buckets, std::memory_order_acq_rel)) {
+                    current = buckets;
+                } else {
+                    Deallocate_bucket_segment(segment, buckets); // Lost the race, use the winner's segment
+                }
+            }
+            return current[bucket_index - Segment_base(segment)];
+        }
+
+        // Returns the dummy of a bucket, splicing it in behind its parent bucket's dummy on first use
+        [[nodiscard]] node *Get_bucket(const size_type bucket_index) const {
+            auto &slot = Bucket_slot(bucket_index);
+            if (const auto dummy = slot.load(std::memory_order_acquire)) {
+                return dummy;
+            }
+
+            const auto parent    = bucket_index & ~std::bit_floor(bucket_index); // Bucket 0 exists from the start
+            const auto new_dummy = Create_dummy_node(Dummy_key(bucket_index));
+
+            auto [dummy, inserted] = Insert_node< true >(Get_bucket(parent), new_dummy);
+            if (!inserted) {
+                Destroy_dummy_node(new_dummy);
+            }
+
+            slot.store(dummy, std::memory_order_release);
+            return dummy;
+        }
+
+        /// <summary>
+        /// Links new_node into the list after start, in split order. If an element with an equal key, or the
+        /// same dummy, is already there, that node is returned instead and new_node is left unlinked.
+        /// Nodes are never unlinked concurrently, so a failed CAS just rescans from the same predecessor.
+        /// IsDummy is a template argument so the key comparison is never compiled in for a bare dummy node.
+        /// </summary>
+        template < bool IsDummy >
+        std::pair< node *, bool > Insert_node(node *start, node *new_node) const {
+            const auto order_key = new_node->mOrderKey;
+            auto       previous  = start;
+            for (;;) {
+                auto next = previous->mNext.load(std::memory_order_acquire);
+                while (next && next->mOrderKey < order_key) {
+                    previous = next;
+                    next     = next->mNext.load(std::memory_order_acquire);
+                }
+
+                if constexpr (IsDummy) {
+                    if (next && next->mOrderKey == order_key) { // Only dummies have an even order key
+                        return { next, false };
+                    }
+                } else {
+                    for (auto same = next; same && same->mOrderKey == order_key;
+                         same      = same->mNext.load(std::memory_order_acquire)) {
+                        if (mEqual(Key_of(same), Key_of(new_node))) {
+                            return { same, false };
+                        }
+                    }
+                }
+
+                new_node->mNext.store(next, std::memory_order_relaxed);
+                if (previous->mNext.compare_exchange_strong(next, new_node, std::memory_order_release,
+                                                            std::memory_order_relaxed)) {
+                    return { new_node, true };
+                }
+            }
+        }
+
+        template < class Predicate >
+        size_type Unlink_if(node *start, const size_type order_key, Predicate &&matches) {
+            auto previous = start;
+            auto current  = previous->mNext.load();
+            while (current && current->mOrderKey < order_key) {
+                previous = std::exchange(current, current->mNext.load());
+            }
+            for (; current && current->mOrderKey == order_key;
+                 previous = std::exchange(current, current->mNext.load())) {
+                if (matches(current)) {
+                    previous->mNext.store(current->mNext.load());
+                    Destroy_value_node(static_cast< value_node * >(current));
+                    mSize.fetch_sub(1);
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+        void Grow_if_overloaded(const size_type size) noexcept {
+            auto bucket_count = mBucketCount.load();
+            if (bucket_count < Max_bucket_count &&
+                static_cast< float >(size) > static_cast< float >(bucket_count) * mMaxLoadFactor.load()) {
+                mBucketCount.compare_exchange_strong(bucket_count, bucket_count * 2);
+            }
+        }
+
+        [[nodiscard]] node *First_element() const noexcept { return iterator::Next_element(mHead); }
+
+        template < class... Args >
+        [[nodiscard]] value_node *Create_value_node(Args &&...args) const {
+            auto       alloc    = value_node_allocator { mAllocator };
+            const auto new_node = alloc.allocate(1);
+            try {
+                value_node_allocator_traits::construct(alloc, new_node, std::forward< Args >(args)...);
+            } catch (...) {
+                alloc.deallocate(new_node, 1);
+                throw;
+            }
+            return new_node;
+        }
+
+        void Destroy_value_node(value_node *element) const noexcept {
+            auto alloc = value_node_allocator { mAllocator };
+            value_node_allocator_traits::destroy(alloc, element);
+            alloc.deallocate(element, 1);
+        }
+
+        [[nodiscard]] node *Create_dummy_node(const size_type order_key) const {
+            auto       alloc = node_allocator { mAllocator };
+            const auto dummy = alloc.allocate(1);
+            node_allocator_traits::construct(alloc, dummy, order_key);
+            return dummy;
+        }
+
+        void Destroy_dummy_node(node *dummy) const noexcept {
+            auto alloc = node_allocator { mAllocator };
+            node_allocator_traits::destroy(alloc, dummy);
+            alloc.deallocate(dummy, 1);
+        }
+
+        void Deallocate_bucket_segment(const size_type segment, bucket *buckets) const noexcept {
+            auto       alloc = bucket_allocator { mAllocator };
+            const auto count = Segment_size(segment);
+            for (size_type i = 0; i < count; ++i) {
+                bucket_allocator_traits::destroy(alloc, buckets + i);
+            }
+            alloc.deallocate(buckets, count);
+        }
+
+        void Initialise() {
+            mHead = Create_dummy_node(Dummy_key(0));
+            try {
+                Bucket_slot(0).store(mHead, std::memory_order_release);
+            } catch (...) {
+                Destroy_dummy_node(std::exchange(mHead, nullptr));
+                throw;
+            }
+        }
+
+        void Finalise() noexcept {
+            auto current = std::exchange(mHead, nullptr);
+            while (current) {
+                const auto next = current->mNext.load();
+                if (current->Is_dummy()) {
+                    Destroy_dummy_node(current);
+                } else {
+                    Destroy_value_node(static_cast< value_node * >(current));
+                }
+                current = next;
+            }
+
+            for (size_type segment = 0; segment < Max_segment_count; ++segment) {
+                if (const auto buckets = mSegments[segment].exchange(nullptr)) {
+                    Deallocate_bucket_segment(segment, buckets);
+                }
+            }
+            mSize.store(0);
+        }
+
+        mutable std::array< std::atomic< bucket * >, Max_segment_count > mSegments {};
+
+        node *                   mHead { nullptr }; // Dummy of bucket 0, the head of the split-ordered list
+        std::atomic< size_type > mBucketCount;
+        std::atomic< size_type > mSize { 0 };
+        std::atomic< float >     mMaxLoadFactor { Default_max_load_factor };
+
+        [[no_unique_address]] hasher         mHash;
+        [[no_unique_address]] key_equal      mEqual;
+        [[no_unique_address]] allocator_type mAllocator;
+    };
+
+} // namespace concurrent
+
+#endif // CONCURRENT_UNORDERED_BASE_HPP
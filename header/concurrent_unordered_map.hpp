@@ -0,0 +1,102 @@
+#ifndef CONCURRENT_UNORDERED_MAP_HPP
+#define CONCURRENT_UNORDERED_MAP_HPP
+
+#include <concurrent_unordered_base.hpp>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace concurrent {
+
+    namespace impl {
+        struct Map_key_of {
+            template < class Pair >
+            [[nodiscard]] constexpr const auto &operator()(const Pair &value) const noexcept {
+                return value.first;
+            }
+        };
+    } // namespace impl
+
+    /// <summary>
+    /// Hash map whose insertions, lookups and iteration run concurrently without locks, see
+    /// concurrent_unordered_base. References and iterators stay valid until the element is erased.
+    /// </summary>
+    template < class Key, class Type, class Hash = std::hash< Key >, class KeyEqual = std::equal_to< Key >,
+               class Allocator = std::allocator< std::pair< const Key, Type > > >
+    class concurrent_unordered_map
+        : public concurrent_unordered_base< Key, std::pair< const Key, Type >, impl::Map_key_of, Hash, KeyEqual,
+                                            Allocator > {
+        using base =
+            concurrent_unordered_base< Key, std::pair< const Key, Type >, impl::Map_key_of, Hash, KeyEqual, Allocator >;
+
+      public:
+        using mapped_type = Type;
+        using typename base::iterator;
+        using typename base::key_type;
+        using typename base::size_type;
+        using typename base::value_type;
+
+        using base::base;
+
+        concurrent_unordered_map() : base() {}
+
+        template < class InputIt >
+        requires(traits::legacy_input_iterator< InputIt >)
+            concurrent_unordered_map(InputIt first, InputIt last, const size_type bucket_count = 0,
+                                     const Hash &hash = Hash {}, const KeyEqual &equal = KeyEqual {},
+                                     const Allocator &allocator = Allocator {}) :
+            base(bucket_count, hash, equal, allocator) {
+            base::insert(first, last);
+        }
+
+        concurrent_unordered_map(std::initializer_list< value_type > values, const size_type bucket_count = 0,
+                                 const Hash &hash = Hash {}, const KeyEqual &equal = KeyEqual {},
+                                 const Allocator &allocator = Allocator {}) :
+            base(bucket_count, hash, equal, allocator) {
+            base::insert(values);
+        }
+
+        // Concurrency-safe, inserts a value-initialised element if the key is missing
+        mapped_type &operator[](const key_type &key) { return try_emplace(key).first->second; }
+
+        mapped_type &operator[](key_type &&key) { return try_emplace(std::move(key)).first->second; }
+
+        // Concurrency-safe
+        [[nodiscard]] mapped_type &at(const key_type &key) { return Checked_find(key)->second; }
+
+        [[nodiscard]] const mapped_type &at(const key_type &key) const { return Checked_find(key)->second; }
+
+        // Concurrency-safe, builds the element only if the key is missing
+        template < class... Args >
+        std::pair< iterator, bool > try_emplace(const key_type &key, Args &&...args) {
+            if (const auto found = base::find(key); found != base::end()) {
+                return { found, false };
+            }
+            return base::emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                                 std::forward_as_tuple(std::forward< Args >(args)...));
+        }
+
+        template < class... Args >
+        std::pair< iterator, bool > try_emplace(key_type &&key, Args &&...args) {
+            if (const auto found = base::find(key); found != base::end()) {
+                return { found, false };
+            }
+            return base::emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                 std::forward_as_tuple(std::forward< Args >(args)...));
+        }
+
+      private:
+        [[nodiscard]] value_type *Checked_find(const key_type &key) const {
+            const auto found = base::Find_node(key);
+            if (!found) {
+                throw std::out_of_range("invalid concurrent_unordered_map<K, T> key");
+            }
+            return &static_cast< typename base::value_node * >(found)->mValue;
+        }
+    };
+
+} // namespace concurrent
+
+#endif // CONCURRENT_UNORDERED_MAP_HPP
@@ -0,0 +1,56 @@
+#ifndef CONCURRENT_UNORDERED_SET_HPP
+#define CONCURRENT_UNORDERED_SET_HPP
+
+#include <concurrent_unordered_base.hpp>
+#include <functional>
+#include <memory>
+
+namespace concurrent {
+
+    namespace impl {
+        struct Set_key_of {
+            template < class Value >
+            [[nodiscard]] constexpr const Value &operator()(const Value &value) const noexcept {
+                return value;
+            }
+        };
+    } // namespace impl
+
+    /// <summary>
+    /// Hash set whose insertions, lookups and iteration run concurrently without locks, see
+    /// concurrent_unordered_base. Elements are immutable, iterator is the same type as const_iterator.
+    /// </summary>
+    template < class Key, class Hash = std::hash< Key >, class KeyEqual = std::equal_to< Key >,
+               class Allocator = std::allocator< Key > >
+    class concurrent_unordered_set
+        : public concurrent_unordered_base< Key, Key, impl::Set_key_of, Hash, KeyEqual, Allocator > {
+        using base = concurrent_unordered_base< Key, Key, impl::Set_key_of, Hash, KeyEqual, Allocator >;
+
+      public:
+        using typename base::size_type;
+        using typename base::value_type;
+
+        using base::base;
+
+        concurrent_unordered_set() : base() {}
+
+        template < class InputIt >
+        requires(traits::legacy_input_iterator< InputIt >)
+            concurrent_unordered_set(InputIt first, InputIt last, const size_type bucket_count = 0,
+                                     const Hash &hash = Hash {}, const KeyEqual &equal = KeyEqual {},
+                                     const Allocator &allocator = Allocator {}) :
+            base(bucket_count, hash, equal, allocator) {
+            base::insert(first, last);
+        }
+
+        concurrent_unordered_set(std::initializer_list< value_type > values, const size_type bucket_count = 0,
+                                 const Hash &hash = Hash {}, const KeyEqual &equal = KeyEqual {},
+                                 const Allocator &allocator = Allocator {}) :
+            base(bucket_count, hash, equal, allocator) {
+            base::insert(values);
+        }
+    };
+
+} // namespace concurrent
+
+#endif // CONCURRENT_UNORDERED_SET_HPP
@@ -1,15 +1,26 @@
 ﻿#ifndef CONCURRENT_VECTOR_HPP
 #define CONCURRENT_VECTOR_HPP
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #include <compare>
+#include <container_stats.hpp>
 #include <iterator>
 #include <limits>
 #include <memory>
-#include <mutex>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <utils.h>
+#include <vector>
 
 namespace concurrent {
 
@@ -19,9 +30,13 @@ namespace concurrent {
     template < class Type, class Allocator = std::allocator< Type > >
     class concurrent_vector;
 
+    /// <summary>
+    /// Random access iterator that remembers the segment it last dereferenced, moving within that segment is
+    /// plain index arithmetic and only crossing into another segment looks the segment table up again
+    /// </summary>
     template < class TConVector, bool IsConst >
     struct concurrent_vector_iterator {
-        using iterator_concept  = std::contiguous_iterator_tag;
+        using iterator_concept  = std::random_access_iterator_tag; // Elements are contiguous per segment only
         using iterator_category = std::random_access_iterator_tag;
         using value_type        = typename TConVector::value_type;
         using difference_type   = typename TConVector::difference_type;
@@ -35,29 +50,21 @@ namespace concurrent {
         friend class concurrent_vector;
 
       public:
-        constexpr concurrent_vector_iterator() noexcept : mIndex(-1), mVector(nullptr), mValue(nullptr) {}
+        constexpr concurrent_vector_iterator() noexcept : mIndex(-1), mVector(nullptr) {}
 
         constexpr concurrent_vector_iterator(TConVector *vector, Size_type index) noexcept :
-            mIndex(index), mVector(vector), mValue(nullptr) {}
+            mIndex(index), mVector(vector) {}
 
         constexpr concurrent_vector_iterator &operator=(const concurrent_vector_iterator &) noexcept = default;
 
-        [[nodiscard]] constexpr reference operator*() const noexcept {
-            if (mValue) {
-                return *mValue;
-            }
-            mValue = std::addressof(mVector->Get_value_at(mIndex));
-
-            return *mValue;
-        }
-        [[nodiscard]] constexpr pointer operator->() const noexcept { return &operator*(); }
+        [[nodiscard]] constexpr reference operator*() const noexcept { return *Address_at(mIndex); }
+        [[nodiscard]] constexpr pointer operator->() const noexcept { return Address_at(mIndex); }
 
         constexpr concurrent_vector_iterator &operator++() noexcept {
             ++mIndex;
-            mValue = nullptr;
             return *this;
         }
-        constexpr concurrent_vector_iterator &operator++(int) noexcept {
+        constexpr concurrent_vector_iterator operator++(int) noexcept {
             concurrent_vector_iterator tmp = *this;
             ++*this;
             return tmp;
@@ -65,10 +72,9 @@ namespace concurrent {
 
         constexpr concurrent_vector_iterator &operator--() noexcept {
             --mIndex;
-            mValue = nullptr;
             return *this;
         }
-        constexpr concurrent_vector_iterator &operator--(int) noexcept {
+        constexpr concurrent_vector_iterator operator--(int) noexcept {
             concurrent_vector_iterator tmp = *this;
             --*this;
             return tmp;
@@ -76,7 +82,6 @@ namespace concurrent {
 
         constexpr concurrent_vector_iterator &operator+=(const difference_type offset) noexcept {
             mIndex += offset;
-            mValue = nullptr;
             return *this;
         }
         constexpr concurrent_vector_iterator &operator-=(const difference_type offset) noexcept {
@@ -84,10 +89,12 @@ namespace concurrent {
         }
 
         [[nodiscard]] constexpr concurrent_vector_iterator operator+(const difference_type offset) const noexcept {
-            return concurrent_vector_iterator { mVector, mIndex + offset };
+            auto tmp = *this;
+            return tmp += offset;
         }
         [[nodiscard]] constexpr concurrent_vector_iterator operator-(const difference_type offset) const noexcept {
-            return concurrent_vector_iterator { mVector, mIndex - offset };
+            auto tmp = *this;
+            return tmp -= offset;
         }
 
         [[nodiscard]] constexpr difference_type operator-(const concurrent_vector_iterator &rhs) const noexcept {
@@ -95,9 +102,7 @@ namespace concurrent {
         }
 
         [[nodiscard]] constexpr reference operator[](const difference_type offset) const noexcept {
-            mValue = std::addressof(mVector->Get_value_at(mIndex + offset));
-
-            return *mValue;
+            return *Address_at(mIndex + offset);
         }
 
         [[nodiscard]] constexpr bool operator==(const concurrent_vector_iterator &rhs) const noexcept {
@@ -111,9 +116,122 @@ namespace concurrent {
         [[nodiscard]] constexpr bool is_valid() const noexcept { return mIndex != static_cast< Size_type >(-1); }
 
       private:
+        [[nodiscard]] constexpr value_type *Address_at(const Size_type index) const noexcept {
+            // Unsigned wrap-around makes this a single comparison for both ends of the cached segment
+            if (index - mSegmentFirst >= mSegmentSize) {
+                const auto segment = TConVector::Segment_index_of(index);
+                mSegmentFirst      = TConVector::Segment_base(segment);
+                mSegmentSize       = TConVector::Segment_size(segment);
+                mSegmentData       = unfancy_ptr(mVector->Get_address_at(mSegmentFirst));
+            }
+            return mSegmentData + (index - mSegmentFirst);
+        }
+
         Size_type           mIndex;
-        mutable value_type *mValue;
         TConVector *        mVector;
+        mutable value_type *mSegmentData { nullptr };
+        mutable Size_type   mSegmentFirst { 0 };
+        mutable Size_type   mSegmentSize { 0 }; // 0 until the first dereference fills the cache
+    };
+
+    /// <summary>
+    /// Forward iterator over the contiguous blocks of an index range, yields one std::span per segment touched
+    /// </summary>
+    template < class TConVector, bool IsConst >
+    struct concurrent_vector_segment_iterator {
+        using element_type      = std::conditional_t< IsConst, const typename TConVector::value_type,
+                                                 typename TConVector::value_type >;
+        using value_type        = std::span< element_type >;
+        using difference_type   = typename TConVector::difference_type;
+        using iterator_category = std::forward_iterator_tag;
+
+      private:
+        using Size_type = typename TConVector::size_type;
+
+      public:
+        constexpr concurrent_vector_segment_iterator() noexcept = default;
+
+        constexpr concurrent_vector_segment_iterator(TConVector *vector, Size_type first, Size_type last) noexcept :
+            mVector(vector), mFirst(first), mLast(last) {}
+
+        [[nodiscard]] constexpr value_type operator*() const noexcept {
+            const auto count = mVector->Segment_run_at(mFirst, mLast);
+            return value_type { std::addressof(mVector->Get_value_at(mFirst)), count };
+        }
+
+        constexpr concurrent_vector_segment_iterator &operator++() noexcept {
+            mFirst += mVector->Segment_run_at(mFirst, mLast);
+            return *this;
+        }
+        constexpr concurrent_vector_segment_iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        [[nodiscard]] constexpr bool operator==(const concurrent_vector_segment_iterator &rhs) const noexcept {
+            return mFirst == rhs.mFirst;
+        }
+
+      private:
+        TConVector *mVector { nullptr };
+        Size_type   mFirst { 0 };
+        Size_type   mLast { 0 };
+    };
+
+    /// <summary>
+    /// Index range of a concurrent_vector that parallel loops can split recursively, like TBB's blocked_range.
+    /// Splits land on segment boundaries where possible, and segments() hands out each part as contiguous spans,
+    /// so kernels run over raw memory instead of going through the vector per element.
+    /// Only elements constructed before the range was created may be visited.
+    /// </summary>
+    template < class TConVector, bool IsConst >
+    class concurrent_vector_range {
+      public:
+        using value_type       = typename TConVector::value_type;
+        using size_type        = typename TConVector::size_type;
+        using difference_type  = typename TConVector::difference_type;
+        using iterator         = concurrent_vector_iterator< TConVector, IsConst >;
+        using segment_iterator = concurrent_vector_segment_iterator< TConVector, IsConst >;
+
+        constexpr concurrent_vector_range(TConVector *vector, size_type first, size_type last,
+                                          size_type grainsize = 1) noexcept :
+            mVector(vector), mFirst(first), mLast(last), mGrainsize(grainsize) {}
+
+        [[nodiscard]] constexpr iterator begin() const noexcept { return iterator { mVector, mFirst }; }
+
+        [[nodiscard]] constexpr iterator end() const noexcept { return iterator { mVector, mLast }; }
+
+        [[nodiscard]] constexpr size_type size() const noexcept { return mLast - mFirst; }
+
+        [[nodiscard]] constexpr bool empty() const noexcept { return mFirst == mLast; }
+
+        [[nodiscard]] constexpr size_type grainsize() const noexcept { return mGrainsize; }
+
+        [[nodiscard]] constexpr bool is_divisible() const noexcept { return size() > mGrainsize; }
+
+        [[nodiscard]] constexpr auto segments() const noexcept {
+            return std::ranges::subrange { segment_iterator { mVector, mFirst, mLast },
+                                           segment_iterator { mVector, mLast, mLast } };
+        }
+
+        // Keeps the lower part and returns the upper one, cutting at the segment boundary at or below the middle
+        // unless that would leave the lower part empty
+        [[nodiscard]] constexpr concurrent_vector_range split() noexcept {
+            const auto middle   = mFirst + size() / 2;
+            const auto boundary = TConVector::Segment_base(TConVector::Segment_index_of(middle));
+            const auto cut      = boundary > mFirst ? boundary : middle;
+
+            concurrent_vector_range upper { mVector, cut, mLast, mGrainsize };
+            mLast = cut;
+            return upper;
+        }
+
+      private:
+        TConVector *mVector;
+        size_type   mFirst;
+        size_type   mLast;
+        size_type   mGrainsize;
     };
 
     template < class Type, class Allocator >
@@ -139,6 +257,9 @@ namespace concurrent {
         using reverse_iterator       = std::reverse_iterator< iterator >;
         using const_reverse_iterator = std::reverse_iterator< const_iterator >;
 
+        using range_type       = concurrent_vector_range< concurrent_vector< Type, Allocator >, false >;
+        using const_range_type = concurrent_vector_range< concurrent_vector< Type, Allocator >, true >;
+
       private:
         template < class TVec >
         struct Finaliser_If_Failed {
@@ -156,51 +277,53 @@ namespace concurrent {
             TVec *toBeFinalised;
         };
 
-        template < class Alloc >
-        struct Temp_Object {
-            using value_type   = typename Alloc::value_type;
-            using alloc_traits = std::allocator_traits< Alloc >;
+        struct move_in_place {};
+        struct copy_in_place {};
+
+        // Only the initial size of segment_traits applies, rounded up to a power of two: the index arithmetic
+        // needs every segment to double the capacity, so growth, maximum and page rounding are fixed
+        static constexpr size_type Min_segment_size =
+            std::bit_ceil(impl::Segment_sizing< Type, size_type >::Initial_size);
+        static_assert(std::has_single_bit(Min_segment_size), "segment sizes must follow a power-of-two schedule");
 
-            template < class... Args >
-            constexpr Temp_Object(Alloc &alloc, Args &&...args) noexcept(
-                noexcept(alloc_traits::construct(alloc, std::addressof(this->mValue), std::forward< Args >(args)...))) :
-                mAlloc(alloc) {
-                alloc_traits::construct(alloc, std::addressof(this->mValue), std::forward< Args >(args)...);
-            }
-            constexpr ~Temp_Object() { alloc_traits::destroy(mAlloc, std::addressof(mValue)); }
+        // Segment 0 holds the indices [0, Min_segment_size), every following segment k holds
+        // [Min_segment_size << (k - 1), Min_segment_size << k), so it doubles the capacity of all segments before it.
+        static constexpr size_type Segment_shift     = static_cast< size_type >(std::countr_zero(Min_segment_size));
+        static constexpr size_type Max_segment_count = std::numeric_limits< size_type >::digits - Segment_shift + 1;
 
-            Temp_Object(const Temp_Object &) = delete;
-            Temp_Object(Temp_Object &&)      = default;
-            Temp_Object &operator=(const Temp_Object &) = delete;
-            Temp_Object &operator=(Temp_Object &&) = default;
+        using segment_table = std::array< std::atomic< pointer >, Max_segment_count >;
 
-            Alloc &    mAlloc;
-            value_type mValue;
-        };
+        // One bit per slot, set once the element in it is constructed. Appends publish through these bits
+        // instead of the size, which counts indices handed out, so readers never need a lock.
+        using ready_word             = std::atomic< std::uint64_t >;
+        using ready_table            = std::array< std::atomic< ready_word * >, Max_segment_count >;
+        using ready_allocator        = typename allocator_traits::template rebind_alloc< ready_word >;
+        using ready_allocator_traits = std::allocator_traits< ready_allocator >;
 
-        struct move_in_place {};
-        struct copy_in_place {};
+        static constexpr size_type Ready_bits = std::numeric_limits< std::uint64_t >::digits;
 
-        struct Data_Segment {
-            pointer       mBegin { nullptr };
-            pointer       mCurrent { nullptr };
-            pointer       mEnd { nullptr };
-            Data_Segment *mSegBefore { nullptr };
-            Data_Segment *mSegAfter { nullptr };
-        };
+        // Elements the allocator would only copy bytes into are filled with memset and copied with memcpy
+        static constexpr bool Is_trivially_filled = traits::is_trivially_copy_constructed_v< Allocator, Type >;
 
-        // TODO: update with a new allocator class
-        using segment_allocator =
-            std::allocator< Data_Segment >; // allocator_traits::template rebind_alloc< Data_Segment >;
-        using segment_allocator_traits = std::allocator_traits< segment_allocator >;
-        using pointer_traits           = std::pointer_traits< pointer >;
+        template < class Iter >
+        static constexpr bool Is_bitwise_copy_source =
+            Is_trivially_filled && ((std::contiguous_iterator< Iter > &&
+                                     std::is_same_v< std::remove_cv_t< std::iter_value_t< Iter > >, Type >) ||
+                                    std::is_same_v< Iter, iterator > || std::is_same_v< Iter, const_iterator >);
 
-        static constexpr size_type Min_segment_size =
-            impl::Min_segment_size_eval< Type, size_type >::value; // Arbitrary starting size ~ 1KB
+        // Fills at least this large are split between threads, each task fills about 256KB
+        static constexpr size_type Parallel_fill_grain =
+            std::max< size_type >(1, (static_cast< size_type >(1) << 18) / sizeof(Type));
 
         template < class TConVector, bool IsConst >
         friend struct concurrent_vector_iterator;
 
+        template < class TConVector, bool IsConst >
+        friend struct concurrent_vector_segment_iterator;
+
+        template < class TConVector, bool IsConst >
+        friend class concurrent_vector_range;
+
       public:
         // Constructors - not concurrency-safe
         constexpr concurrent_vector() noexcept(noexcept(std::is_nothrow_constructible_v< Allocator >)) {}
@@ -227,38 +350,16 @@ namespace concurrent {
 
         constexpr concurrent_vector(const concurrent_vector &rhs) :
             mAllocator(allocator_traits::select_on_container_copy_construction(rhs.mAllocator)) {
-            {
-                std::scoped_lock Guard { rhs.mMutex };
-                const auto       rhsBegin   = rhs.begin();
-                const auto       rhsCurrent = rhs.End();
-
-                if (rhsBegin != rhsCurrent) {
-                    Do_in_place_n< copy_in_place >(static_cast< size_type >(rhsCurrent - rhsBegin), rhsBegin,
-                                                   rhsCurrent);
-                }
-            }
+            Do_in_place_n< copy_in_place >(rhs.Get_size(), rhs.begin());
         }
 
-        constexpr concurrent_vector(const concurrent_vector &rhs, const Allocator &alloc) {
-            {
-                std::scoped_lock Guard { rhs.mMutex };
-                const auto       rhsBegin   = rhs.begin();
-                const auto       rhsCurrent = rhs.End();
-
-                if (rhsBegin != rhsCurrent) {
-                    Do_in_place_n< copy_in_place >(static_cast< size_type >(rhsCurrent - rhsBegin), rhsBegin,
-                                                   rhsCurrent);
-                }
-            }
+        constexpr concurrent_vector(const concurrent_vector &rhs, const Allocator &alloc) : mAllocator(alloc) {
+            Do_in_place_n< copy_in_place >(rhs.Get_size(), rhs.begin());
         }
 
-        constexpr concurrent_vector(concurrent_vector &&other) noexcept :
-            mAllocator(std::move(other.mAllocator)),
-            mSegmentAllocator(std::move(other.mSegmentAllocator)),
-            mSegment(std::exchange(other.mSegment, nullptr)),
-            mCurrent(std::exchange(other.mCurrent, nullptr)),
-            mEnd(std::exchange(other.mEnd, nullptr)),
-            mMutex(std::exchange(other.mMutex, nullptr)) {}
+        constexpr concurrent_vector(concurrent_vector &&other) noexcept : mAllocator(std::move(other.mAllocator)) {
+            Steal_segments(other);
+        }
 
         constexpr concurrent_vector(concurrent_vector &&other, const Allocator &alloc) noexcept(
             noexcept(allocator_traits::is_always_equal::value)) :
@@ -301,26 +402,22 @@ namespace concurrent {
         // assign - not concurrency-safe
         constexpr void assign(const size_type count, const Type &value) {
             {
-                auto current_size = Get_size();
+                Reset_if_broken();
 
-                if (count > current_size) {
-                    const auto current_capacity = Get_capacity();
-                    if (count > current_capacity) {
-                        Deallocate_then_allocate(count);
+                const auto current_size = Get_size();
+                const auto reused_size  = std::min(current_size, count);
 
-                        mSegment.mCurrent = std::fill_n(begin(), count, value);
-                    }
-
-                    auto location_iter = std::fill_n(begin(), count, value);
-                    mCurrent           = Adjust_segments_and_get_last_address_for(location_iter.mIndex);
+                For_each_segment_in(0, reused_size, [&](pointer target, size_type segment_count) {
+                    std::fill_n(target, segment_count, value);
+                });
 
+                if (count > current_size) {
+                    Allocate_segments_for(count);
+                    Fill_n(current_size, count - current_size, value);
                 } else {
-                    const auto new_mCurrent = begin() + count;
-                    (void)std::fill_n(begin(), count, value);
-
-                    Destruct(new_mCurrent, End());
-                    mCurrent = Adjust_segments_and_get_last_address_for(new_mCurrent.mIndex);
+                    Destruct(count, current_size);
                 }
+                mSize.store(count);
             }
         }
 
@@ -334,16 +431,13 @@ namespace concurrent {
         }
 
         // get allocator - concurrency-safe
-        [[nodiscard]] constexpr allocator_type get_allocator() const noexcept {
-            std::scoped_lock Guard { mMutex };
-            return mAllocator;
-        }
+        [[nodiscard]] constexpr allocator_type get_allocator() const noexcept { return mAllocator; }
 
+        /// Element access - concurrency-safe, lock-free
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Throws for indices a concurrent push_back/grow_by has handed out but not finished constructing
         [[nodiscard]] constexpr reference at(size_type pos) {
-            std::scoped_lock Guard { mMutex };
-
-            if (Get_size() <= pos) {
+            if (Get_size() <= pos || !Is_ready(pos)) {
                 throw_range_exception();
             }
 
@@ -351,51 +445,35 @@ namespace concurrent {
         }
 
         [[nodiscard]] constexpr const_reference at(size_type pos) const {
-            std::scoped_lock Guard { mMutex };
-
-            if (Get_size() <= pos) {
+            if (Get_size() <= pos || !Is_ready(pos)) {
                 throw_range_exception();
             }
 
             return Get_value_at(pos);
         }
 
-        [[nodiscard]] constexpr reference operator[](size_type pos) noexcept {
-            std::scoped_lock Guard { mMutex };
-            return Get_value_at(pos);
-        }
+        // Elements never move once constructed, reading one that is known to be constructed needs no lock
+        [[nodiscard]] constexpr reference operator[](size_type pos) noexcept { return Get_value_at(pos); }
 
-        [[nodiscard]] constexpr const_reference operator[](size_type pos) const noexcept {
-            std::scoped_lock Guard { mMutex };
-            return Get_value_at(pos);
-        }
+        [[nodiscard]] constexpr const_reference operator[](size_type pos) const noexcept { return Get_value_at(pos); }
 
-        [[nodiscard]] constexpr reference front() noexcept {
-            std::scoped_lock Guard { mMutex };
-            return mSegment.mBegin[0];
-        }
+        [[nodiscard]] constexpr reference front() noexcept { return Get_value_at(0); }
 
-        [[nodiscard]] constexpr const_reference front() const noexcept {
-            std::scoped_lock Guard { mMutex };
-            return mSegment.mBegin[0];
-        }
+        [[nodiscard]] constexpr const_reference front() const noexcept { return Get_value_at(0); }
 
+        // The last index handed out, a concurrent append may still be constructing it; at() checks that
         [[nodiscard]] constexpr reference back() noexcept {
-            std::scoped_lock Guard { mMutex };
-            if (!mCurrent)
-                return Type {}; // undefined-behaviour
-            return mCurrent->mCurrent[-1];
+            return Get_value_at(Get_size() - 1); // undefined-behaviour if empty
         }
 
         [[nodiscard]] constexpr const_reference back() const noexcept {
-            std::scoped_lock Guard { mMutex };
-            if (!mCurrent)
-                return Type {}; // undefined-behaviour
-            return mCurrent->mCurrent[-1];
+            return Get_value_at(Get_size() - 1); // undefined-behaviour if empty
         }
 
-        /// Iterators - concurrency-safe
+        /// Iterators - not concurrency-safe with appends in flight
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // end() is size(), which counts indices concurrent appends are still constructing and whose segment may not
+        // be installed yet. Readers running beside appends take range() or snapshot() instead
         constexpr iterator begin() noexcept { return Return_iterator(0); }
 
         constexpr const_iterator begin() const noexcept { return Return_const_iterator(0); }
@@ -420,52 +498,92 @@ namespace concurrent {
 
         constexpr const_reverse_iterator crend() const noexcept { return rend(); }
 
-        /// Capacity - concurrency-safe
+        /// Ranges - concurrency-safe, cover the elements constructed when they are created
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Ends at the first index a concurrent append is still constructing, or whose append threw
+        constexpr range_type range(const size_type grainsize = 1) noexcept {
+            return range_type { this, 0, Ready_prefix(Get_size()), grainsize };
+        }
 
-        [[nodiscard]] constexpr bool empty() const noexcept {
-            std::scoped_lock Guard { mMutex };
-            return mSegment.mBegin == mSegment.mCurrent;
+        constexpr const_range_type range(const size_type grainsize = 1) const noexcept {
+            return const_range_type { const_cast< concurrent_vector * >(this), 0, Ready_prefix(Get_size()),
+                                      grainsize };
         }
 
-        [[nodiscard]] constexpr size_type size() const noexcept {
-            {
-                std::scoped_lock Guard { mMutex };
-                return Get_size();
+        // Contiguous std::span blocks covering range(), one per segment or per run of segments stored back to
+        // back, a single block after compact()
+        constexpr auto segments() noexcept { return range().segments(); }
+
+        constexpr auto segments() const noexcept { return range().segments(); }
+
+        /// Snapshots - concurrency-safe, appends may continue meanwhile
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Copies the elements into one contiguous std::vector. The copy stops short of the first index a concurrent
+        // append is still constructing, large copies are split between threads like the fills
+        [[nodiscard]] std::vector< Type, Allocator > snapshot() const {
+            const auto count = Ready_prefix(Get_size());
+            if constexpr (std::is_default_constructible_v< Type > && std::is_copy_assignable_v< Type >) {
+                std::vector< Type, Allocator > copy(count, mAllocator);
+                Copy_out_n(count, copy.data());
+                return copy;
+            } else {
+                std::vector< Type, Allocator > copy(mAllocator);
+                copy.reserve(count);
+                For_each_segment_in(0, count, [&copy](const_pointer source, const size_type segment_count) {
+                    copy.insert(copy.end(), source, source + segment_count);
+                });
+                return copy;
             }
         }
 
+        // Copies the leading elements into dest, at most dest.size() of them, and returns how many were copied
+        size_type snapshot(const std::span< Type > dest) const {
+            const auto count = Ready_prefix(std::min(Get_size(), static_cast< size_type >(dest.size())));
+            Copy_out_n(count, dest.data());
+            return count;
+        }
+
+        /// Capacity - concurrency-safe, lock-free
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] constexpr bool empty() const noexcept { return Get_size() == 0; }
+
+        // Counts the elements that are still being constructed by concurrent push_back/grow_by calls
+        [[nodiscard]] constexpr size_type size() const noexcept { return Get_size(); }
+
         [[nodiscard]] constexpr size_type max_size() const noexcept {
             return static_cast< size_type >(std::numeric_limits< size_type >::max());
         }
 
         // Not concurrency-safe
-        constexpr void reserve(const size_type new_cap) {
-            if (new_cap > Get_capacity()) {
-                Append_new_segment(new_cap);
-            }
-        }
+        constexpr void reserve(const size_type new_cap) { Allocate_segments_for(new_cap); }
 
-        [[nodiscard]] constexpr size_type capacity() const noexcept {
-            {
-                std::scoped_lock Guard { mMutex };
-                return Get_capacity();
-            }
-        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept { return Get_capacity(); }
+
+        // Concurrency-safe, see container_stats for what is counted and how to enable it
+        [[nodiscard]] container_stats stats() const { return mStats.Snapshot(); }
 
         // Not concurrency-safe
         constexpr void shrink_to_fit() { // invalidates all the iterators
             {
-                if (mCurrent != mEnd || mCurrent->mCurrent != mCurrent->mEnd) {
-                    if (&mSegment == mCurrent && mSegment.mBegin == mSegment.mCurrent) {
-                        Finalise_no_lock();
-                        return;
-                    }
-                    Reallocate_to_fit_n(Get_size());
-                }
+                const auto size          = Get_size();
+                const auto used_segments = size == 0 ? 0 : Segment_index_of(size - 1) + 1;
+                Deallocate_segments_from(used_segments);
             }
         }
 
+        // Not concurrency-safe, invalidates all the iterators. Moves the elements of a segment chain left by many
+        // growth steps into a single allocation and frees the unused segments, so segments() yields one span.
+        // Appends after it add segments again. If an element constructor throws the vector is left unchanged
+        constexpr void compact() {
+            const auto size          = Get_size();
+            const auto used_segments = size == 0 ? 0 : Segment_index_of(size - 1) + 1;
+            if (used_segments > std::max< size_type >(mFirstBlock, 1)) {
+                Merge_segments(used_segments);
+            }
+            Deallocate_segments_from(used_segments);
+        }
+
         /// Modifiers - not concurrency-safe
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -473,22 +591,82 @@ namespace concurrent {
             // clear does not free internal arrays.
             // To free internal arrays, call the function shrink_to_fit after clear
             Destruct();
-            mCurrent = Adjust_segments_and_get_last_address_for(0);
+            mSize.store(0);
+            mBrokenCount.store(0);
+        }
+
+        // clear with the destructor calls split between executor tasks by index range, the calling thread takes
+        // the first range. Below two fill grains, or without a second hardware thread, it is a plain clear
+        template < class Executor = async_executor >
+        void clear_parallel(Executor executor = Executor {}) {
+            const auto size       = Get_size();
+            const auto task_count = traits::is_trivially_destroyed_v< Allocator, Type > ? 1 : Parallel_task_count(size);
+            if (task_count > 1) {
+                // Multiples of a ready word per task, so tasks seldom clear bits of the same word
+                const auto chunk_size = (size / task_count + Ready_bits) & ~(Ready_bits - 1);
+                impl::Run_chunks(executor, task_count, [this, size, chunk_size](const std::size_t chunk) {
+                    const auto first = std::min(size, static_cast< size_type >(chunk) * chunk_size);
+                    Destruct(first, std::min(size, first + chunk_size));
+                });
+            }
+            clear();
+        }
+
+        /// <summary>
+        /// Detaches every segment in O(1) and hands them, with the elements still in them, to one executor task
+        /// that destroys and frees them, so the calling thread goes on at once with an empty vector that owns no
+        /// storage. Returns the executor's handle on that task. The future of async_executor waits for the task
+        /// when it is destroyed, keep it for as long as the caller should not block. If the task can not be
+        /// started the storage is destroyed on the calling thread and the exception is rethrown
+        /// </summary>
+        template < class Executor = async_executor >
+        [[nodiscard]] auto clear_deferred(Executor executor = Executor {}) {
+            auto detached = std::make_unique< concurrent_vector >(mAllocator);
+            detached->Steal_segments(*this);
+
+            auto handle = executor([storage = detached.get()]() noexcept { delete storage; });
+            (void)detached.release();
+            return handle;
+        }
+
+        // Destroys the last element, or gives back the index of an append that threw. With no other thread
+        // writing, the ready bit is cleared without a read-modify-write
+        constexpr void pop_back() noexcept { // undefined-behaviour if empty
+            const auto last = Get_size() - 1;
+            if (Is_ready(last)) {
+                For_each_ready_word_in(last, last + 1, [](ready_word &word, const std::uint64_t mask, size_type) {
+                    word.store(word.load(std::memory_order_relaxed) & ~mask, std::memory_order_relaxed);
+                });
+                if constexpr (!traits::is_trivially_destroyed_v< Allocator, Type >) {
+                    allocator_traits::destroy(mAllocator, unfancy_ptr(Get_address_at(last)));
+                }
+            } else {
+                mBrokenCount.fetch_sub(1);
+            }
+            mSize.store(last, std::memory_order_relaxed);
         }
 
         // Concurrency-safe
         template < class... Args >
         constexpr reference emplace_back(Args &&...args) {
-            {
-                std::scoped_lock Guard { mMutex };
-                if ((mCurrent != mEnd) || (mCurrent->mCurrent != mCurrent->mEnd)) {
-                    auto result = Emplace_at_without_reallocation(Get_size(), std::forward< Args >(args)...);
-                    mCurrent->mCurrent++;
-                    return *result;
-                }
+            const auto index = mSize.fetch_add(1);
+            if (index == max_size()) {
+                throw_length_exception();
+            }
 
-                return *Emplace_back_with_reallocation(std::forward< Args >(args)...);
+            const auto segment = Segment_index_of(index);
+            pointer    target {};
+            try {
+                target = Install_segment(segment) + (index - Segment_base(segment));
+                allocator_traits::construct(mAllocator, unfancy_ptr(target), std::forward< Args >(args)...);
+            } catch (...) {
+                mBrokenCount.fetch_add(1);
+                throw;
             }
+
+            Publish(index, index + 1);
+            mStats.Count_push();
+            return *target;
         }
 
         // Concurrency-safe
@@ -497,154 +675,400 @@ namespace concurrent {
         // Concurrency-safe
         constexpr void push_back(Type &&value) { emplace_back(std::move(value)); }
 
-        constexpr void grow_by(const size_type count) { grow_by(count, Type {}); }
+        constexpr iterator grow_by(const size_type count) { return grow_by(count, Type {}); }
 
-        constexpr void grow_by(const size_type count, const Type &value) {
-            {
-                std::scoped_lock Guard { mMutex };
-                const auto       current_size = Get_size();
-                const auto       new_size     = current_size + count;
-
-                (void)Check_size< size_type >(static_cast< size_t >(new_size));
+        // Concurrency-safe, returns an iterator to the first appended element
+        constexpr iterator grow_by(const size_type count, const Type &value) {
+            if (count == 0) {
+                return End();
+            }
+            if (count > max_size() - Get_size()) {
+                throw_length_exception();
+            }
 
-                // Grow
-                const auto current_capacity = Get_capacity();
+            const auto first = mSize.fetch_add(count);
+            Append_filled(first, first + count, value);
+            return Return_iterator(first);
+        }
 
-                if (new_size > current_capacity) {
-                    // Append new segment
-                    Append_new_segment(Calculate_new_segment_size(new_size));
-                }
+        constexpr iterator grow_to_at_least(const size_type new_size) { return grow_to_at_least(new_size, Type {}); }
 
-                const auto newCurrent = begin() + new_size;
-                Fill_n(End(), count, value);
-                mCurrent = Adjust_segments_and_get_last_address_for(newCurrent.mIndex);
+        // Concurrency-safe, appends copies of value until the vector holds at least new_size elements.
+        // Returns an iterator to the first appended element, or to new_size if the vector was large enough.
+        constexpr iterator grow_to_at_least(const size_type new_size, const Type &value) {
+            auto current = mSize.load();
+            while (current < new_size && !mSize.compare_exchange_weak(current, new_size)) {
+            }
 
-                return;
+            if (current < new_size) {
+                Append_filled(current, new_size, value);
             }
+            return Return_iterator(std::min(current, new_size));
         }
 
         constexpr void swap(concurrent_vector &rhs) noexcept {
-            static_assert(allocator_traits::propagate_on_container_swap::value,
+            static_assert(allocator_traits::propagate_on_container_swap::value ||
+                              allocator_traits::is_always_equal::value,
                           "container's allocator can not be swapped!");
             if (this != std::addressof(rhs)) {
-                std::swap(mAllocator, rhs.mAllocator);
-                std::swap(mSegment, rhs.mSegment);
-                std::swap(mCurrent, rhs.mCurrent);
-                std::swap(mEnd, rhs.mEnd);
+                if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                    std::swap(mAllocator, rhs.mAllocator);
+                }
+                if constexpr (container_stats::enabled) { // Each side's bytes_held follows its segments
+                    const auto bytes     = Held_bytes();
+                    const auto rhs_bytes = rhs.Held_bytes();
+                    mStats.Count_release(bytes);
+                    mStats.Count_adoption(rhs_bytes);
+                    rhs.mStats.Count_release(rhs_bytes);
+                    rhs.mStats.Count_adoption(bytes);
+                }
+                for (size_type segment = 0; segment < Max_segment_count; ++segment) {
+                    mSegments[segment].store(rhs.mSegments[segment].exchange(mSegments[segment].load()));
+                    mReady[segment].store(rhs.mReady[segment].exchange(mReady[segment].load()));
+                }
+                mSize.store(rhs.mSize.exchange(mSize.load()));
+                std::swap(mFirstBlock, rhs.mFirstBlock);
+                mBrokenCount.store(rhs.mBrokenCount.exchange(mBrokenCount.load()));
             }
         }
 
       private:
-        [[nodiscard]] inline constexpr size_type Get_size() const noexcept {
-            size_type result = 0;
-            auto      iter   = &mSegment;
-            do {
-                result += static_cast< size_type >(iter->mCurrent - iter->mBegin);
-                iter = iter->mSegAfter;
-            } while (iter && iter != mCurrent);
+        [[nodiscard]] static constexpr size_type Segment_index_of(const size_type index) noexcept {
+            return static_cast< size_type >(std::bit_width(index >> Segment_shift));
+        }
 
-            if (iter) {
-                result += static_cast< size_type >(iter->mCurrent - iter->mBegin);
-            }
+        [[nodiscard]] static constexpr size_type Segment_base(const size_type segment) noexcept {
+            return (static_cast< size_type >(1) << segment) >> 1 << Segment_shift;
+        }
 
-            return result;
+        [[nodiscard]] static constexpr size_type Segment_size(const size_type segment) noexcept {
+            return segment == 0 ? Min_segment_size : Segment_base(segment);
+        }
+
+        // Length of the contiguous run starting at index first, cut off at last. Segments stored back to back, as
+        // in the first block, extend the run
+        [[nodiscard]] constexpr size_type Segment_run_at(const size_type first, const size_type last) const noexcept {
+            auto segment = Segment_index_of(first);
+            auto run_end = Segment_base(segment) + Segment_size(segment);
+            while (run_end < last) {
+                const auto storage = mSegments[segment].load(std::memory_order_acquire);
+                if (mSegments[segment + 1].load(std::memory_order_acquire) != storage + Segment_size(segment)) {
+                    break;
+                }
+                run_end += Segment_size(++segment);
+            }
+            return std::min(run_end, last) - first;
         }
 
+        [[nodiscard]] inline constexpr size_type Get_size() const noexcept { return mSize.load(); }
+
         [[nodiscard]] inline constexpr size_type Get_capacity() const noexcept {
-            size_type result = 0;
-            auto      iter   = &mSegment;
-            do {
-                result += static_cast< size_type >(iter->mEnd - iter->mBegin);
-                iter = iter->mSegAfter;
-            } while (iter);
+            size_type segment = 0;
+            while (segment < Max_segment_count && mSegments[segment].load(std::memory_order_acquire)) {
+                ++segment;
+            }
+            return Segment_base(segment);
+        }
+
+        inline constexpr pointer Get_address_at(size_type index) const noexcept { // index must be less than capacity()
+            const auto segment = Segment_index_of(index);
+            return mSegments[segment].load(std::memory_order_acquire) + (index - Segment_base(segment));
+        }
 
-            return result;
+        [[nodiscard]] inline bool Is_ready(const size_type index) const noexcept {
+            const auto segment = Segment_index_of(index);
+            const auto words   = mReady[segment].load(std::memory_order_acquire);
+            const auto offset  = index - Segment_base(segment);
+            return words && (words[offset / Ready_bits].load(std::memory_order_acquire) >> offset % Ready_bits & 1);
         }
 
         inline constexpr reference Get_value_at(size_type index) noexcept { // index must be less than size()
-            Data_Segment *target_segment = &mSegment;
-            for (;;) {
-                const auto segment_size = static_cast< size_type >(target_segment->mEnd - target_segment->mBegin);
-                if (index < segment_size) {
-                    return target_segment->mBegin[index];
-                } else {
-                    index -= segment_size;
-                }
-                target_segment = target_segment->mSegAfter;
+            return *Get_address_at(index);
+        }
+        inline constexpr const_reference Get_value_at(size_type index) const noexcept {
+            return *Get_address_at(index);
+        }
+
+        /// <summary>
+        /// Calls func(segment_pointer, count) for every contiguous part of the index range [first, last)
+        /// </summary>
+        template < class Func >
+        inline constexpr void For_each_segment_in(size_type first, const size_type last, Func &&func) const {
+            while (first < last) {
+                const auto segment = Segment_index_of(first);
+                const auto offset  = first - Segment_base(segment);
+                const auto count   = std::min(Segment_size(segment) - offset, last - first);
+
+                func(mSegments[segment].load(std::memory_order_acquire) + offset, count);
+                first += count;
             }
         }
 
-        inline constexpr Data_Segment *
-            Get_segment_address(size_type index) const noexcept { // index must be less than size()
-            // Traverse
-            Data_Segment *target_segment = &mSegment;
-            for (;;) {
-                const auto segment_size = static_cast< size_type >(target_segment->mEnd - target_segment->mBegin);
-                if (index < segment_size) {
-                    break;
-                } else {
-                    index -= segment_size;
-                }
-                target_segment = target_segment->mSegAfter;
+        /// <summary>
+        /// Calls func(word, mask, word_first) for every ready word overlapping [first, last), mask selects the
+        /// bits of the range and bit 0 of the word stands for index word_first
+        /// </summary>
+        template < class Func >
+        inline constexpr void For_each_ready_word_in(size_type first, const size_type last, Func &&func) const {
+            while (first < last) {
+                const auto segment = Segment_index_of(first);
+                const auto offset  = first - Segment_base(segment);
+                const auto bit     = offset % Ready_bits;
+                const auto count   = std::min({ Ready_bits - bit, Segment_size(segment) - offset, last - first });
+                const auto mask    = (count == Ready_bits ? ~std::uint64_t { 0 } : (std::uint64_t { 1 } << count) - 1)
+                                  << bit;
+
+                func(mReady[segment].load(std::memory_order_acquire)[offset / Ready_bits], mask, first - bit);
+                first += count;
             }
+        }
 
-            return target_segment;
+        // Calls func(index) for every published index of [first, last), in ascending order
+        template < class Func >
+        inline constexpr void For_each_ready_index_in(const size_type first, const size_type last, Func &&func) const {
+            For_each_ready_word_in(first, last, [&func](ready_word &word, const std::uint64_t mask, size_type index) {
+                for (auto ready = word.load(std::memory_order_acquire) & mask; ready != 0; ready &= ready - 1) {
+                    func(index + static_cast< size_type >(std::countr_zero(ready)));
+                }
+            });
         }
 
-        inline constexpr Data_Segment *
-            Adjust_segments_and_get_last_address_for(size_type index) noexcept { // index must be equal to size()
-            // Traverse
-            Data_Segment *target_segment = &mSegment;
-            while (target_segment) {
-                const auto segment_size = static_cast< size_type >(target_segment->mEnd - target_segment->mBegin);
-                if (index < segment_size) {
-                    target_segment->mCurrent = target_segment->mBegin + index;
-                    break;
-                } else {
-                    index -= segment_size;
+        // Makes the constructed elements [first, last) visible to at()
+        inline constexpr void Publish(const size_type first, const size_type last) noexcept {
+            For_each_ready_word_in(first, last, [](ready_word &word, const std::uint64_t mask, size_type) {
+                word.fetch_or(mask, std::memory_order_release);
+            });
+        }
+
+        // First index below last whose element is not published yet, every element before it can be read
+        [[nodiscard]] size_type Ready_prefix(const size_type last) const noexcept {
+            size_type index = 0;
+            while (index < last) { // Starts every segment at its base, so a word always begins at bit 0
+                const auto segment = Segment_index_of(index);
+                const auto words   = mReady[segment].load(std::memory_order_acquire);
+                if (!words) {
+                    return index;
                 }
-                target_segment->mCurrent = target_segment->mEnd;
-                target_segment           = target_segment->mSegAfter;
+
+                const auto segment_end = std::min(Segment_base(segment) + Segment_size(segment), last);
+                for (auto word = words; index < segment_end; ++word) {
+                    const auto count = std::min(Ready_bits, segment_end - index);
+                    const auto mask  = count == Ready_bits ? ~std::uint64_t { 0 } : (std::uint64_t { 1 } << count) - 1;
+                    if (const auto missing = ~word->load(std::memory_order_acquire) & mask; missing != 0) {
+                        return index + static_cast< size_type >(std::countr_zero(missing));
+                    }
+                    index += count;
+                }
+            }
+            return last;
+        }
+
+        // Copy assigns the published elements [0, count) to dest, split between async_executor tasks when large
+        void Copy_out_n(const size_type count, Type *dest) const {
+            const auto copy_chunk = [this, dest](const size_type first, const size_type last) {
+                For_each_segment_in(first, last, [target = dest + first](const_pointer source,
+                                                                         const size_type segment_count) mutable {
+                    target = std::copy(unfancy_ptr(source), unfancy_ptr(source) + segment_count, target);
+                });
+            };
+
+            const auto task_count = Parallel_task_count(count);
+            if (task_count <= 1) {
+                copy_chunk(0, count);
+                return;
+            }
+
+            const auto chunk_size = (count + task_count - 1) / task_count;
+            auto       executor   = async_executor {};
+            impl::Run_chunks(executor, task_count, [&copy_chunk, chunk_size, count](const std::size_t chunk) {
+                const auto first = static_cast< size_type >(chunk) * chunk_size;
+                copy_chunk(first, std::min(count, first + chunk_size));
+            });
+        }
+
+        // Threads worth splitting count elements between, 1 for work below two grains
+        [[nodiscard]] static size_type Parallel_task_count(const size_type count) noexcept {
+            if (count < 2 * Parallel_fill_grain) {
+                return 1;
+            }
+            return std::max< size_type >(
+                1, std::min< size_type >(std::thread::hardware_concurrency(), count / Parallel_fill_grain));
+        }
+
+        inline constexpr void Allocate_segments_for(const size_type new_cap) {
+            if (new_cap <= Get_capacity()) {
+                return;
+            }
+
+            const auto last_segment = Segment_index_of(new_cap - 1);
+            if (!mSegments[0].load()) {
+                Allocate_first_block(last_segment + 1);
+                return;
+            }
+
+            for (size_type segment = 0; segment <= last_segment; ++segment) {
+                (void)Install_segment(segment);
+            }
+        }
+
+        /// <summary>
+        /// Returns the storage of a segment, allocating it if no other thread has installed it yet
+        /// </summary>
+        inline constexpr pointer Install_segment(const size_type segment) {
+            auto current = mSegments[segment].load(std::memory_order_acquire);
+            if (current) {
+                return current;
+            }
+
+            Install_ready_words(segment); // Before the storage, whoever sees a segment can publish into it
+
+            const auto new_segment = mAllocator.allocate(Segment_size(segment));
+            mStats.Count_allocation(Segment_size(segment) * sizeof(Type));
+            if (mSegments[segment].compare_exchange_strong(current, new_segment, std::memory_order_acq_rel)) {
+                return new_segment;
+            }
+
+            mAllocator.deallocate(new_segment, Segment_size(segment)); // Lost the race, use the winner's segment
+            mStats.Count_release(Segment_size(segment) * sizeof(Type));
+            return current;
+        }
+
+        /// <summary>
+        /// Allocates the segments [0, segment_count) as one block, so an initial batch is stored contiguously
+        /// </summary>
+        inline constexpr void Allocate_first_block(const size_type segment_count) {
+            for (size_type segment = 0; segment < segment_count; ++segment) {
+                Install_ready_words(segment);
+            }
+
+            const auto block = mAllocator.allocate(Segment_base(segment_count));
+            mStats.Count_allocation(Segment_base(segment_count) * sizeof(Type));
+            for (size_type segment = 0; segment < segment_count; ++segment) {
+                mSegments[segment].store(block + Segment_base(segment), std::memory_order_release);
+            }
+
+            mFirstBlock = segment_count;
+        }
+
+        /// <summary>
+        /// Moves the published elements of the segments [0, segment_count) into one new block and installs it as the
+        /// first block. The old storage is only released once every element has been built in the new one
+        /// </summary>
+        inline constexpr void Merge_segments(const size_type segment_count) {
+            for (size_type segment = 0; segment < segment_count; ++segment) {
+                Install_ready_words(segment); // Segments an append failed to allocate get empty ones
             }
 
-            if (target_segment) {
-                auto reseted_segments = target_segment->mSegAfter;
-                for (; reseted_segments; reseted_segments = reseted_segments->mSegAfter) {
-                    reseted_segments->mCurrent = reseted_segments->mBegin;
+            const auto size     = Get_size();
+            const auto capacity = Segment_base(segment_count);
+            const auto block    = mAllocator.allocate(capacity);
+            mStats.Count_allocation(capacity * sizeof(Type));
+
+            if constexpr (Is_trivially_filled) {
+                For_each_segment_in(0, size, [block, index = size_type { 0 }](pointer source,
+                                                                              const size_type count) mutable {
+                    if (source) {
+                        std::memcpy(unfancy_ptr(block + index), unfancy_ptr(source), count * sizeof(Type));
+                    }
+                    index += count;
+                });
+            } else {
+                size_type built = 0; // Published elements below this index have been built in block
+                try {
+                    For_each_ready_index_in(0, size, [&](const size_type index) {
+                        allocator_traits::construct(mAllocator, unfancy_ptr(block + index),
+                                                    std::move_if_noexcept(*Get_address_at(index)));
+                        built = index + 1;
+                    });
+                } catch (...) {
+                    For_each_ready_index_in(0, built, [&](const size_type index) {
+                        allocator_traits::destroy(mAllocator, unfancy_ptr(block + index));
+                    });
+                    mAllocator.deallocate(block, capacity);
+                    mStats.Count_release(capacity * sizeof(Type));
+                    throw;
+                }
+
+                if constexpr (!traits::is_trivially_destroyed_v< Allocator, Type >) {
+                    For_each_ready_index_in(0, size, [this](const size_type index) {
+                        allocator_traits::destroy(mAllocator, unfancy_ptr(Get_address_at(index)));
+                    });
                 }
             }
 
-            return target_segment;
+            for (auto segment = mFirstBlock; segment < segment_count; ++segment) {
+                if (const auto storage = mSegments[segment].exchange(block + Segment_base(segment))) {
+                    mAllocator.deallocate(storage, Segment_size(segment));
+                    mStats.Count_release(Segment_size(segment) * sizeof(Type));
+                }
+            }
+            if (mFirstBlock != 0) {
+                mAllocator.deallocate(mSegments[0].load(), Segment_base(mFirstBlock));
+                mStats.Count_release(Segment_base(mFirstBlock) * sizeof(Type));
+                for (size_type segment = 0; segment < mFirstBlock; ++segment) {
+                    mSegments[segment].store(block + Segment_base(segment));
+                }
+            }
+            mFirstBlock = segment_count;
         }
 
-        inline constexpr void Append_new_segment(size_type seg_size) {
-            if (mCurrent == &mSegment && !mSegment.mBegin) {
-                const auto newBegin = mAllocator.allocate(seg_size);
-                mSegment.mBegin     = newBegin;
-                mSegment.mCurrent   = newBegin;
-                mSegment.mEnd       = newBegin + seg_size;
-                mSegment.mSegBefore = nullptr;
-                mSegment.mSegAfter  = nullptr;
+        [[nodiscard]] static constexpr size_type Ready_word_count(const size_type segment) noexcept {
+            return (Segment_size(segment) + Ready_bits - 1) / Ready_bits;
+        }
 
+        inline void Install_ready_words(const size_type segment) {
+            ready_word *current = mReady[segment].load(std::memory_order_acquire);
+            if (current) {
                 return;
             }
 
-            auto       newSegment = mSegmentAllocator.allocate(1);
-            const auto newBegin   = mAllocator.allocate(seg_size);
+            auto       alloc = ready_allocator { mAllocator };
+            const auto words = alloc.allocate(Ready_word_count(segment));
+            for (size_type word = 0; word < Ready_word_count(segment); ++word) {
+                ready_allocator_traits::construct(alloc, words + word, 0);
+            }
 
-            newSegment->mBegin     = newBegin;
-            newSegment->mCurrent   = newBegin;
-            newSegment->mEnd       = newBegin + seg_size;
-            newSegment->mSegBefore = mCurrent;
-            newSegment->mSegAfter  = nullptr;
+            if (!mReady[segment].compare_exchange_strong(current, words, std::memory_order_acq_rel)) {
+                Deallocate_ready_words(segment, words);
+            }
+        }
 
-            mCurrent->mSegAfter = newSegment;
-            mEnd                = newSegment;
+        inline void Deallocate_ready_words(const size_type segment, ready_word *words) noexcept {
+            auto alloc = ready_allocator { mAllocator };
+            for (size_type word = 0; word < Ready_word_count(segment); ++word) {
+                ready_allocator_traits::destroy(alloc, words + word);
+            }
+            alloc.deallocate(words, Ready_word_count(segment));
         }
 
-        inline constexpr size_type Calculate_new_segment_size(size_type new_capacity) const noexcept {
-            const auto [new_capacity_, current_capacity] = Calculate_new_capacity(new_capacity);
-            return std::max(Min_segment_size, new_capacity_ - current_capacity);
+        inline constexpr void Deallocate_segments_from(const size_type first_segment) noexcept {
+            // Segments inside the first block share its allocation, they are only freed together with segment 0
+            const auto first_freed = first_segment == 0 ? 0 : std::max(first_segment, mFirstBlock);
+
+            // Concurrent growth may have installed segments out of order, so every table entry is inspected
+            for (auto segment = std::max(first_segment, mFirstBlock); segment < Max_segment_count; ++segment) {
+                if (const auto storage = mSegments[segment].exchange(nullptr)) {
+                    mAllocator.deallocate(storage, Segment_size(segment));
+                    mStats.Count_release(Segment_size(segment) * sizeof(Type));
+                }
+            }
+
+            if (first_segment == 0 && mFirstBlock != 0) {
+                mAllocator.deallocate(mSegments[0].load(), Segment_base(mFirstBlock));
+                mStats.Count_release(Segment_base(mFirstBlock) * sizeof(Type));
+                for (size_type segment = 0; segment < mFirstBlock; ++segment) {
+                    mSegments[segment].store(nullptr);
+                }
+
+                mFirstBlock = 0;
+            }
+
+            // Segments that keep their storage keep their ready words, Install_segment only adds both together
+            for (auto segment = first_freed; segment < Max_segment_count; ++segment) {
+                if (const auto words = mReady[segment].exchange(nullptr)) {
+                    Deallocate_ready_words(segment, words);
+                }
+            }
         }
 
         template < class InputIt >
@@ -652,7 +1076,7 @@ namespace concurrent {
             const auto count = Check_size< size_type >(static_cast< size_t >(std::distance(first, last)),
                                                        "input iterator range is too long!");
 
-            Do_in_place_n< copy_in_place >(count, first, last);
+            Do_in_place_n< copy_in_place >(count, first);
         }
         template < class InputIt >
         inline constexpr void Construct_range(InputIt first, InputIt last,
@@ -668,37 +1092,45 @@ namespace concurrent {
 
         template < class InputIt >
         inline constexpr void Assign_range(InputIt first, InputIt last, std::forward_iterator_tag) {
+            Reset_if_broken();
+
             const auto current_size = Get_size();
             const auto new_size     = Check_size< size_type >(static_cast< size_t >(std::distance(first, last)));
+            const auto reused_size  = std::min(current_size, new_size);
 
-            if (new_size > current_size) {
-                const auto current_capacity = Get_capacity();
-                if (new_size > current_capacity) {
-                    Deallocate_then_allocate(new_size);
+            For_each_segment_in(0, reused_size, [&](pointer target, size_type count) {
+                if constexpr (std::contiguous_iterator< InputIt >) { // Becomes a memmove for trivially copyable types
+                    std::copy_n(std::to_address(first), count, unfancy_ptr(target));
+                    first += static_cast< std::iter_difference_t< InputIt > >(count);
+                } else {
+                    for (const auto segment_end = target + count; target != segment_end; ++target, (void)++first) {
+                        *target = *first;
+                    }
                 }
+            });
 
-                Copy_n(begin(), first, last);
-                mCurrent = Adjust_segments_and_get_last_address_for(new_size);
+            if (new_size > current_size) {
+                Allocate_segments_for(new_size);
+                Copy_n(current_size, new_size - current_size, first);
             } else {
-                const auto begin_it       = begin();
-                const auto new_current_it = begin_it + new_size;
-                Copy_n(begin_it, first, last);
-                Destruct(new_current_it, End());
-                mCurrent = Adjust_segments_and_get_last_address_for(new_current_it.mIndex);
+                Destruct(new_size, current_size);
             }
+            mSize.store(new_size);
         }
         template < class InputIt >
         inline constexpr void Assign_range(InputIt first, InputIt last, std::input_iterator_tag) {
-            iterator target  = begin();
-            iterator current = End();
+            Reset_if_broken();
+
+            const auto current_size = Get_size();
+            size_type  target       = 0;
 
             // Copy only within used range
-            for (; first != last && target != current; ++first, (void)++target) {
-                *target = *first;
+            for (; first != last && target != current_size; ++first, (void)++target) {
+                Get_value_at(target) = *first;
             }
 
-            Destruct(target, current);
-            mCurrent = Adjust_segments_and_get_last_address_for(target.mIndex);
+            Destruct(target, current_size);
+            mSize.store(target);
 
             // If more elements need to be copied, emplace_back them
             for (; first != last; ++first) {
@@ -706,174 +1138,231 @@ namespace concurrent {
             }
         }
 
-        template < class... Args >
-        inline constexpr auto
-            Emplace_at_without_reallocation(const size_type location, Args &&...args) noexcept(noexcept(
-                std::is_nothrow_move_assignable_v< Type >) &&noexcept(std::is_nothrow_move_constructible_v< Type >)) {
-            iterator location_iter { this, location };
-
-            if (location == End().mIndex) {
-                allocator_traits::construct(mAllocator, unfancy_ptr(location_iter), std::forward< Args >(args)...);
-            } else {
-                // if the required location has been occupied by an existing element,
-                // the inserted element is constructed at another location at first
-                auto                     end_iter        = End();
-                auto                     before_end_iter = end_iter - 1;
-                Temp_Object< Allocator > mTempObj { mAllocator, std::forward< Args >(args)... };
-
-                allocator_traits::construct(mAllocator, unfancy_ptr(end_iter), std::move(*before_end_iter));
-                Move_backward_n(end_iter, location_iter, before_end_iter);
-                *location_iter = std::move(mTempObj.mValue);
-            }
-
-            return pointer_traits::pointer_to(*location_iter);
-        }
-
-        template < class... Args >
-        inline constexpr auto Emplace_back_with_reallocation(Args &&...args) { // more nodes needed
-            const auto current_size = Get_size();
-            if (current_size == max_size()) {
-                throw_length_exception();
-            }
-
-            const auto new_size         = current_size + 1;
-            const auto new_segment_size = Calculate_new_segment_size(new_size);
-
-            Append_new_segment(new_segment_size);
-            if (current_size != 0) {
-                mCurrent = mCurrent->mSegAfter;
-            }
-
-            allocator_traits::construct(mAllocator, unfancy_ptr(mCurrent->mCurrent), std::forward< Args >(args)...);
-
-            mCurrent->mCurrent++;
-
-            return pointer_traits::pointer_to(*(End() - 1));
-        }
-
         inline constexpr void Construct_in_place_n(size_type count, const Type &val) {
             if (count != 0) {
-                Allocate_new_n(count);
+                Allocate_segments_for(count);
 
                 Finaliser_If_Failed< concurrent_vector > finaliser { this };
-                Fill_n(mCurrent->mCurrent, count, val);
-                mCurrent->mCurrent += count;
+                Fill_n(0, count, val);
+                mSize.store(count);
                 finaliser.NoFinalise();
             }
         }
         template < class TCommand, class InputIt >
-        inline constexpr void Do_in_place_n(size_type count, InputIt first, InputIt last) {
+        inline constexpr void Do_in_place_n(size_type count, InputIt first) {
             static_assert(
                 std::disjunction_v< std::is_same< TCommand, copy_in_place >, std::is_same< TCommand, move_in_place > >);
 
             if (count != 0) {
-                Allocate_new_n(count);
+                Allocate_segments_for(count);
 
                 Finaliser_If_Failed< concurrent_vector > finaliser { this };
 
                 if constexpr (std::same_as< TCommand, copy_in_place >) {
-                    Copy_n(mCurrent->mCurrent, first, last);
+                    Copy_n(0, count, first);
                 } else if constexpr (std::same_as< TCommand, move_in_place >) {
-                    Move_n(mCurrent->mCurrent, first, last);
+                    Move_n(0, count, first);
                 }
-                mCurrent->mCurrent += count;
+                mSize.store(count);
 
                 finaliser.NoFinalise();
             }
         }
-        inline constexpr void Allocate_new_n(const size_type new_cap) {
-            (void)Check_size< size_type >(static_cast< std::size_t >(new_cap));
 
-            const auto new_vec  = mAllocator.allocate(new_cap);
-            mSegment.mBegin     = new_vec;
-            mSegment.mCurrent   = new_vec;
-            mSegment.mEnd       = new_vec + new_cap;
-            mSegment.mSegBefore = nullptr;
-            mSegment.mSegAfter  = nullptr;
-            mCurrent            = &mSegment;
-            mEnd                = &mSegment;
+        // These set of functions construct elements in the allocated index range [first, first + count) and
+        // publish them together, elements constructed before an exception is thrown are destroyed again
+        template < class Constructor >
+        inline constexpr void Construct_n(const size_type first, const size_type count, Constructor &&constructor) {
+            Construct_unpublished_n(first, count, std::forward< Constructor >(constructor));
+            Publish(first, first + count);
         }
-        inline constexpr void Reallocate_to_fit_n(const size_type new_cap) {
-            (void)Check_size< size_type >(static_cast< std::size_t >(new_cap));
-
-            const auto data_size = Get_size();
-            const auto newBegin  = mAllocator.allocate(new_cap);
-
+        template < class Constructor >
+        inline constexpr void Construct_unpublished_n(const size_type first, const size_type count,
+                                                      Constructor &&constructor) {
+            size_type constructed = 0;
             try {
-                Move_or_copy_n(newBegin, begin(), End());
+                For_each_segment_in(first, first + count, [&](pointer target, size_type segment_count) {
+                    for (const auto segment_end = target + segment_count; target != segment_end; ++target) {
+                        constructor(target);
+                        ++constructed;
+                    }
+                });
             } catch (...) {
-                mAllocator.deallocate(newBegin, new_cap);
+                Destruct_constructed(first, first + constructed);
                 throw;
             }
-
-            Exchange_data(newBegin, data_size, new_cap);
         }
-
-        // These set of functions have to be used on a contiguous target block or a forward iterator
-        template < class TargetIt >
-        inline constexpr void Fill_n(TargetIt target, size_type count, const Type &val) {
-            for (; count > 0; --count) {
-                allocator_traits::construct(mAllocator, unfancy_ptr(target), val);
-                ++target;
+        inline constexpr void Fill_n(const size_type first, const size_type count, const Type &val) {
+            if (count >= 2 * Parallel_fill_grain && std::thread::hardware_concurrency() > 1) {
+                Parallel_fill_n(first, count, val);
+            } else {
+                Fill_unpublished_n(first, count, val);
             }
+            Publish(first, first + count);
         }
-        template < class TargetIt, class InputIt >
-        inline constexpr void Copy_n(TargetIt target, InputIt first, InputIt last) {
-            for (; first < last; ++first) {
-                allocator_traits::construct(mAllocator, unfancy_ptr(target), *unfancy_ptr(first));
-                ++target;
+        inline constexpr void Fill_unpublished_n(const size_type first, const size_type count, const Type &val) {
+            if constexpr (Is_trivially_filled) {
+                For_each_segment_in(first, first + count, [&val](pointer target, size_type segment_count) {
+                    Fill_trivially(unfancy_ptr(target), segment_count, val);
+                });
+            } else {
+                Construct_unpublished_n(first, count, [&](pointer target) {
+                    allocator_traits::construct(mAllocator, unfancy_ptr(target), val);
+                });
             }
         }
-        template < class TargetIt, class InputIt >
-        inline constexpr void Move_n(TargetIt target, InputIt first, InputIt last) {
-            for (; first < last; ++first) {
-                allocator_traits::construct(mAllocator, unfancy_ptr(target),
-                                            std::forward< Type >(std::move(*unfancy_ptr(first))));
-                ++target;
+        static void Fill_trivially(Type *target, const size_type count, const Type &val) noexcept {
+            unsigned char bytes[sizeof(Type)];
+            std::memcpy(bytes, std::addressof(val), sizeof(Type));
+
+            if (std::all_of(bytes, bytes + sizeof(Type), [&bytes](unsigned char byte) { return byte == bytes[0]; })) {
+                std::memset(target, bytes[0], count * sizeof(Type)); // Zero-initialisation in particular
+            } else {
+                std::uninitialized_fill_n(target, count, val);
             }
         }
-        template < class TargetIt, class InputIt >
-        inline constexpr void Move_backward_n(TargetIt target, InputIt first, InputIt last) {
-            while (first != last) {
-                *--target = std::move(*--last);
+
+        /// <summary>
+        /// Splits the filling of [first, first + count) into chunks built by async_executor tasks, the calling
+        /// thread takes the first one. If any chunk throws the others are destroyed once every task has finished
+        /// </summary>
+        inline void Parallel_fill_n(const size_type first, const size_type count, const Type &val) {
+            const auto task_count =
+                std::min< size_type >(std::thread::hardware_concurrency(), count / Parallel_fill_grain);
+            const auto chunk_size = (count + task_count - 1) / task_count;
+            const auto fill_chunk = [this, first, count, chunk_size, &val](const size_type chunk) {
+                const auto chunk_first = first + chunk * chunk_size;
+                Fill_unpublished_n(chunk_first, std::min(chunk_size, first + count - chunk_first), val);
+            };
+
+            auto executor = async_executor {};
+            using handle  = decltype(executor([] {}));
+
+            std::vector< handle > tasks {};
+            std::exception_ptr    failure {};
+            std::vector< bool >   filled(task_count, false);
+            try {
+                tasks.reserve(task_count - 1);
+                for (size_type chunk = 1; chunk < task_count; ++chunk) {
+                    tasks.push_back(executor([&fill_chunk, chunk]() { fill_chunk(chunk); }));
+                }
+                fill_chunk(0);
+                filled[0] = true;
+            } catch (...) {
+                failure = std::current_exception();
+            }
+
+            for (size_type task = 0; task < tasks.size(); ++task) {
+                try {
+                    tasks[task].get();
+                    filled[task + 1] = true;
+                } catch (...) {
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+            }
+
+            if (failure) {
+                for (size_type chunk = 0; chunk < task_count; ++chunk) {
+                    if (filled[chunk]) {
+                        const auto chunk_first = first + chunk * chunk_size;
+                        Destruct_constructed(chunk_first, std::min(chunk_first + chunk_size, first + count));
+                    }
+                }
+                std::rethrow_exception(failure);
             }
         }
-        template < class TargetIt, class InputIt >
-        inline constexpr void Move_or_copy_n(TargetIt target, InputIt first, InputIt last) {
-            if constexpr (std::is_nothrow_move_constructible_v< Type > || !std::is_copy_constructible_v< Type >) {
-                Move_n(target, first, last);
+        template < class InputIt >
+        inline constexpr void Copy_n(const size_type first, const size_type count, InputIt source) {
+            if constexpr (Is_bitwise_copy_source< InputIt >) {
+                For_each_segment_in(first, first + count, [&source](pointer target, size_type segment_count) {
+                    Copy_bytes(unfancy_ptr(target), source, segment_count);
+                    source += static_cast< difference_type >(segment_count);
+                });
+                Publish(first, first + count);
             } else {
-                Copy_n(target, first, last);
+                Construct_n(first, count, [&](pointer target) {
+                    allocator_traits::construct(mAllocator, unfancy_ptr(target), *source);
+                    ++source;
+                });
             }
         }
-
-        inline constexpr void Deallocate_then_allocate(const size_type new_size) {
-            if (new_size > max_size()) {
-                throw_length_exception();
+        template < class InputIt >
+        static void Copy_bytes(Type *target, const InputIt &source, const size_type count) noexcept {
+            if constexpr (std::contiguous_iterator< InputIt >) {
+                std::memcpy(target, std::to_address(source), count * sizeof(Type));
+            } else { // Another concurrent_vector, its segments need not line up with ours
+                const auto first = source.mIndex;
+                for (const auto block : const_range_type { source.mVector, first, first + count }.segments()) {
+                    std::memcpy(target, block.data(), block.size_bytes());
+                    target += block.size();
+                }
             }
-            Finaliser_If_Failed< concurrent_vector > finaliser { this };
+        }
+        template < class InputIt >
+        inline constexpr void Move_n(const size_type first, const size_type count, InputIt source) {
+            if constexpr (Is_bitwise_copy_source< InputIt >) { // Moving these is copying their bytes
+                Copy_n(first, count, source);
+                return;
+            }
+
+            Construct_n(first, count, [&](pointer target) {
+                allocator_traits::construct(mAllocator, unfancy_ptr(target), std::move(*source));
+                ++source;
+            });
+        }
 
-            const auto [new_cap, _] = Calculate_new_capacity(new_size);
+        // Builds the reserved indices [first, last) of a concurrent append
+        inline constexpr void Append_filled(const size_type first, const size_type last, const Type &value) {
+            try {
+                for (auto segment = Segment_index_of(first); segment <= Segment_index_of(last - 1); ++segment) {
+                    (void)Install_segment(segment);
+                }
+                Fill_n(first, last - first, value);
+            } catch (...) {
+                mBrokenCount.fetch_add(last - first);
+                throw;
+            }
+            mStats.Count_push(last - first);
+        }
 
-            Finalise_no_lock();
-            Allocate_new_n(new_cap);
+        // Bytes of the segments this vector owns, the ready words are not counted
+        [[nodiscard]] constexpr std::size_t Held_bytes() const noexcept {
+            auto bytes = std::size_t { 0 };
+            for (size_type segment = 0; segment < Max_segment_count; ++segment) {
+                if (mSegments[segment].load()) {
+                    bytes += Segment_size(segment) * sizeof(Type);
+                }
+            }
+            return bytes;
+        }
 
-            finaliser.NoFinalise();
+        // The segments change owner and take their share of bytes_held with them
+        inline constexpr void Steal_segments(concurrent_vector &other) noexcept {
+            if constexpr (container_stats::enabled) {
+                const auto bytes = other.Held_bytes();
+                other.mStats.Count_release(bytes);
+                mStats.Count_adoption(bytes);
+            }
+            for (size_type segment = 0; segment < Max_segment_count; ++segment) {
+                mSegments[segment].store(other.mSegments[segment].exchange(nullptr));
+            }
+            mSize.store(other.mSize.exchange(0));
+            for (size_type segment = 0; segment < Max_segment_count; ++segment) {
+                mReady[segment].store(other.mReady[segment].exchange(nullptr));
+            }
+            mFirstBlock = std::exchange(other.mFirstBlock, 0);
+            mBrokenCount.store(other.mBrokenCount.exchange(0));
         }
 
         inline constexpr void move_construct(concurrent_vector &&other, std::true_type) noexcept {
-            mSegment = std::exchange(other.mSegment, nullptr);
-            mCurrent = std::exchange(other.mCurrent, nullptr);
-            mEnd     = std::exchange(other.mEnd, nullptr);
+            Steal_segments(other);
         }
         inline constexpr void move_construct(concurrent_vector &&other, std::false_type) {
             if constexpr (!allocator_traits::is_always_equal::value) {
                 if (mAllocator != other.mAllocator) {
-                    const auto rhsBegin   = other.begin();
-                    const auto rhsCurrent = other.End();
-                    if (rhsBegin != rhsCurrent) {
-                        Do_in_place_n< move_in_place >(static_cast< size_type >(rhsCurrent - rhsBegin), begin(), End());
-                    }
+                    Do_in_place_n< move_in_place >(other.Get_size(), other.begin());
                     return;
                 }
             }
@@ -895,58 +1384,46 @@ namespace concurrent {
         }
 
         inline constexpr void Finalise_no_lock() noexcept {
-            auto segment_tracker = mEnd;
-            while (segment_tracker) {
-                Destruct_contiguous(segment_tracker->mBegin, segment_tracker->mCurrent);
-                mAllocator.deallocate(segment_tracker->mBegin,
-                                      static_cast< size_type >(segment_tracker->mEnd - segment_tracker->mBegin));
-
-                segment_tracker->mBegin    = nullptr;
-                segment_tracker->mCurrent  = nullptr;
-                segment_tracker->mEnd      = nullptr;
-                segment_tracker->mSegAfter = nullptr;
-
-                Data_Segment *delete_segment = nullptr;
-                if (segment_tracker->mSegBefore) {
-                    delete_segment = segment_tracker;
-                }
-
-                segment_tracker = segment_tracker->mSegBefore;
-
-                if (delete_segment) {
-                    mSegmentAllocator.deallocate(delete_segment, 1);
+            Destruct();
+            mSize.store(0);
+            mBrokenCount.store(0);
+            Deallocate_segments_from(0);
+        }
+        inline constexpr void Finalise() noexcept { Finalise_no_lock(); }
+
+        inline constexpr void Destruct() noexcept { Destruct(0, Get_size()); }
+        // Destroys the published elements of [first, last), slots whose append threw hold none and are skipped
+        inline constexpr void Destruct(const size_type first, const size_type last) noexcept {
+            For_each_ready_word_in(first, last, [this](ready_word &word, const std::uint64_t mask, size_type index) {
+                auto ready = word.fetch_and(~mask, std::memory_order_relaxed) & mask;
+                if constexpr (!traits::is_trivially_destroyed_v< Allocator, Type >) {
+                    for (; ready != 0; ready &= ready - 1) {
+                        const auto target = Get_address_at(index + static_cast< size_type >(std::countr_zero(ready)));
+                        allocator_traits::destroy(mAllocator, unfancy_ptr(target));
+                    }
                 }
-            }
-
-            mEnd     = &mSegment;
-            mCurrent = &mSegment;
+            });
         }
-        inline constexpr void Finalise() noexcept {
-            {
-                std::scoped_lock Guard { mMutex };
-                Finalise_no_lock();
+        inline constexpr void Destruct_constructed(const size_type first, const size_type last) noexcept {
+            if constexpr (traits::is_trivially_destroyed_v< Allocator, Type >) {
+                return;
             }
-        }
 
-        inline constexpr void Destruct() noexcept { Destruct(begin(), End()); }
-        inline constexpr void Destruct(iterator first, iterator last) noexcept {
-            for (; first != last; ++first) {
-                allocator_traits::destroy(mAllocator, unfancy_ptr(first));
-            }
-        }
-        inline constexpr void Destruct_contiguous(pointer first, pointer last) noexcept {
-            auto begin_   = first;
-            auto current_ = last;
-            for (; begin_ != current_; ++begin_) {
-                allocator_traits::destroy(mAllocator, unfancy_ptr(begin_));
-            }
+            For_each_segment_in(first, last, [&](pointer target, size_type count) {
+                for (const auto segment_end = target + count; target != segment_end; ++target) {
+                    allocator_traits::destroy(mAllocator, unfancy_ptr(target));
+                }
+            });
         }
-        inline constexpr void Exchange_data(pointer newBegin, size_type dataSize, size_type dataCapacity) {
-            Finalise_no_lock();
 
-            mSegment.mBegin   = newBegin;
-            mSegment.mCurrent = newBegin + dataSize;
-            mSegment.mEnd     = newBegin + dataCapacity;
+        // A concurrent append whose element constructor threw can not give its reserved indices back and leaves
+        // them unpublished. Such slots can not be assigned to, a vector that has any is rebuilt from scratch.
+        inline constexpr void Reset_if_broken() noexcept {
+            if (mBrokenCount.load() != 0) {
+                Destruct();
+                mSize.store(0);
+                mBrokenCount.store(0);
+            }
         }
 
         inline constexpr iterator       End() noexcept { return Return_iterator(Get_size()); }
@@ -955,8 +1432,8 @@ namespace concurrent {
         [[nodiscard]] inline constexpr iterator Return_iterator(const size_type offset) noexcept {
             return iterator { this, offset };
         }
-        [[nodiscard]] inline constexpr iterator Return_const_iterator(const size_type offset) const noexcept {
-            return const_iterator { this, offset };
+        [[nodiscard]] inline constexpr const_iterator Return_const_iterator(const size_type offset) const noexcept {
+            return const_iterator { const_cast< concurrent_vector * >(this), offset };
         }
 
         template < class SizeType >
@@ -968,23 +1445,6 @@ namespace concurrent {
 
             return static_cast< SizeType >(size);
         }
-        [[nodiscard]] inline constexpr auto Calculate_new_capacity(const size_type new_size) const noexcept {
-            // Geometry growth MSVC's vector algorithm
-            const size_type current_capacity = Get_capacity();
-            const auto      size_limit       = max_size();
-
-            if (current_capacity > size_limit - current_capacity / 2) {
-                return std::make_pair(size_limit, current_capacity);
-            }
-
-            const size_type Size = current_capacity + current_capacity / 2;
-
-            if (Size < new_size) {
-                return std::make_pair(new_size, current_capacity);
-            }
-
-            return std::make_pair(Size, current_capacity);
-        }
         [[noreturn]] static void throw_length_exception(const char *message = "vector size is too long!") {
             throw std::length_error(message);
         }
@@ -992,12 +1452,14 @@ namespace concurrent {
             throw std::out_of_range(message);
         }
 
-        Data_Segment       mSegment {};
-        Data_Segment *     mCurrent { &mSegment };
-        Data_Segment *     mEnd { &mSegment };
-        mutable std::mutex mMutex {};
-        allocator_type     mAllocator {};
-        segment_allocator  mSegmentAllocator {};
+        segment_table            mSegments {};
+        ready_table              mReady {};
+        std::atomic< size_type > mSize { 0 };        // Indices handed out to appending threads
+        std::atomic< size_type > mBrokenCount { 0 }; // Indices whose append threw
+        size_type                mFirstBlock { 0 };  // Segments [0, mFirstBlock) share a single allocation
+        allocator_type           mAllocator {};
+
+        [[no_unique_address]] impl::Stats_recorder mStats {};
     };
 
 } // namespace concurrent
@@ -0,0 +1,234 @@
+#ifndef CONCURRENT_WORK_STEALING_DEQUE_HPP
+#define CONCURRENT_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <epoch_reclaimer.hpp>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <utils.h>
+
+namespace concurrent {
+
+    /// <summary>
+    /// Chase-Lev work-stealing deque. The owning thread pushes and pops at the bottom without any
+    /// read-modify-write except when it races a thief for the last element, other threads steal from the
+    /// top with a single CAS. Elements live in atomic slots, so they have to be trivially copyable; task
+    /// pointers or small handles are the intended payload.
+    /// </summary>
+    template < class Type, class Allocator = std::allocator< Type > >
+    class concurrent_work_stealing_deque {
+        static_assert(std::is_same_v< Type, typename Allocator::value_type >,
+                      "concurrent_work_stealing_deque<T, Allocator> requires its allocator type to match T");
+        static_assert(std::is_trivially_copyable_v< Type >,
+                      "concurrent_work_stealing_deque<T, Allocator> requires T to be trivially copyable");
+
+      private:
+        using allocator_traits = std::allocator_traits< Allocator >;
+
+      public:
+        using value_type      = Type;
+        using allocator_type  = Allocator;
+        using size_type       = typename allocator_traits::size_type;
+        using difference_type = std::int64_t; // Top and bottom only grow, they must not wrap in practice
+        using reference       = Type &;
+        using const_reference = const Type &;
+
+      private:
+        using slot = std::atomic< Type >;
+
+        /// <summary>
+        /// Circular array of slots, the index of an element is its position modulo the capacity.
+        /// A thief may still read a buffer the owner has outgrown, so outgrown buffers are retired to the
+        /// epoch reclaimer and freed once no steal that could have loaded them is still running.
+        /// </summary>
+        struct Buffer {
+            size_type        mMask { 0 };
+            slot *           mSlots { nullptr };
+            Buffer *         mRetiredNext { nullptr };
+            impl::epoch_type mRetireEpoch { 0 };
+
+            slot &operator[](const difference_type idx) const noexcept {
+                return mSlots[static_cast< size_type >(idx) & mMask];
+            }
+            size_type capacity() const noexcept { return mMask + 1; }
+        };
+
+        using buffer_allocator        = typename allocator_traits::template rebind_alloc< Buffer >;
+        using buffer_allocator_traits = std::allocator_traits< buffer_allocator >;
+        using slot_allocator          = typename allocator_traits::template rebind_alloc< slot >;
+        using slot_allocator_traits   = std::allocator_traits< slot_allocator >;
+
+        // The whole deque lives in one ring buffer, so only initial size and growth factor of segment_traits apply
+        using segment_sizing = impl::Segment_sizing< Type, size_type >;
+
+        static constexpr size_type Min_capacity = std::bit_ceil(segment_sizing::Initial_size);
+
+        struct Buffer_reclaim {
+            concurrent_work_stealing_deque *mOwner;
+
+            void operator()(Buffer *buffer) const noexcept { mOwner->Deallocate_buffer(buffer); }
+        };
+
+        // Buffers only retire when the deque grows, so each one is collected on the next growth at the latest
+        using epoch_reclaimer = impl::Epoch_reclaimer< Buffer, Buffer_reclaim, 1 >;
+
+        // Thieves read the buffer inside a guard, the owner never reads one it has retired
+        using Steal_guard = typename epoch_reclaimer::Guard;
+
+      public:
+        explicit concurrent_work_stealing_deque(const allocator_type &allocator = allocator_type {}) :
+            mAllocator(allocator) {
+            mBuffer.store(Allocate_buffer(Min_capacity), std::memory_order_relaxed);
+        }
+
+        concurrent_work_stealing_deque(const concurrent_work_stealing_deque &) = delete;
+        concurrent_work_stealing_deque &operator=(const concurrent_work_stealing_deque &) = delete;
+
+        ~concurrent_work_stealing_deque() { Finalise(); }
+
+        allocator_type get_allocator() const { return mAllocator; }
+
+        // Owner thread only
+        void push(const Type &value) {
+            const auto bottom = mBottom.load(std::memory_order_relaxed);
+            const auto top    = mTop.load(std::memory_order_acquire);
+            auto       buffer = mBuffer.load(std::memory_order_relaxed);
+
+            if (bottom - top >= static_cast< difference_type >(buffer->capacity())) {
+                buffer = Grow(buffer, bottom, top);
+            }
+
+            (*buffer)[bottom].store(value, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        // Owner thread only, takes the most recently pushed element
+        bool try_pop(Type &dest) {
+            const auto bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            const auto buffer = mBuffer.load(std::memory_order_relaxed);
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            auto top = mTop.load(std::memory_order_relaxed);
+            if (top > bottom) { // Empty
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            const auto value = (*buffer)[bottom].load(std::memory_order_relaxed);
+            if (top == bottom) { // Last element, thieves may be after it too
+                const auto won = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                              std::memory_order_relaxed);
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                if (!won) {
+                    return false;
+                }
+            }
+
+            dest = value;
+            return true;
+        }
+
+        // Any thread, takes the oldest element. Fails when the deque is empty or another thread won the race.
+        bool try_steal(Type &dest) {
+            Steal_guard guard { mReclaimer };
+
+            auto top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto bottom = mBottom.load(std::memory_order_acquire);
+            if (top >= bottom) {
+                return false;
+            }
+
+            const auto buffer = mBuffer.load(std::memory_order_acquire);
+            const auto value  = (*buffer)[top].load(std::memory_order_relaxed);
+            if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+
+            dest = value;
+            return true;
+        }
+
+        // Concurrency-safe, the result may already be stale
+        [[nodiscard]] size_type size_hint() const noexcept {
+            const auto bottom = mBottom.load(std::memory_order_relaxed);
+            const auto top    = mTop.load(std::memory_order_relaxed);
+            return static_cast< size_type >(bottom > top ? bottom - top : 0);
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return size_hint() == 0; }
+
+      private:
+        // Owner thread only, copies the live range [top, bottom) into a buffer grown like concurrent_queue's
+        // segments, rounded up to a power of two so indices wrap with a mask. Retiring the old buffer needs a
+        // guard, it is taken before anything can throw and leaving it frees the buffers no steal still reads.
+        Buffer *Grow(Buffer *buffer, const difference_type bottom, const difference_type top) {
+            Steal_guard guard { mReclaimer };
+
+            const auto new_capacity = std::bit_ceil(segment_sizing::New_capacity(buffer->capacity() + 1));
+            const auto new_buffer   = Allocate_buffer(new_capacity);
+            for (auto idx = top; idx < bottom; ++idx) {
+                (*new_buffer)[idx].store((*buffer)[idx].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+
+            mBuffer.store(new_buffer, std::memory_order_release);
+            mReclaimer.Retire(buffer);
+            return new_buffer;
+        }
+
+        Buffer *Allocate_buffer(const size_type capacity) {
+            auto alloc  = buffer_allocator { mAllocator };
+            auto buffer = alloc.allocate(1);
+            buffer_allocator_traits::construct(alloc, buffer);
+
+            auto slot_alloc = slot_allocator { mAllocator };
+            try {
+                buffer->mSlots = slot_alloc.allocate(capacity);
+            } catch (...) {
+                buffer_allocator_traits::destroy(alloc, buffer);
+                alloc.deallocate(buffer, 1);
+                throw;
+            }
+
+            for (size_type i = 0; i < capacity; ++i) {
+                slot_allocator_traits::construct(slot_alloc, buffer->mSlots + i);
+            }
+            buffer->mMask = capacity - 1;
+            return buffer;
+        }
+
+        void Deallocate_buffer(Buffer *buffer) noexcept {
+            const auto capacity = buffer->capacity();
+
+            auto slot_alloc = slot_allocator { mAllocator };
+            for (size_type i = 0; i < capacity; ++i) {
+                slot_allocator_traits::destroy(slot_alloc, buffer->mSlots + i);
+            }
+            slot_alloc.deallocate(buffer->mSlots, capacity);
+
+            auto alloc = buffer_allocator { mAllocator };
+            buffer_allocator_traits::destroy(alloc, buffer);
+            alloc.deallocate(buffer, 1);
+        }
+
+        void Finalise() noexcept {
+            Deallocate_buffer(mBuffer.exchange(nullptr));
+            mReclaimer.Drain();
+        }
+
+        alignas(impl::Cache_line_size) std::atomic< difference_type > mTop { 0 };    // Contended by thieves
+        alignas(impl::Cache_line_size) std::atomic< difference_type > mBottom { 0 }; // Written by the owner only
+        std::atomic< Buffer * > mBuffer { nullptr };
+        epoch_reclaimer         mReclaimer { Buffer_reclaim { this } };
+
+        allocator_type mAllocator {};
+    };
+
+} // namespace concurrent
+
+#endif // CONCURRENT_WORK_STEALING_DEQUE_HPP
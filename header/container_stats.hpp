@@ -0,0 +1,143 @@
+#ifndef CONTAINER_STATS_HPP
+#define CONTAINER_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef CONCURRENT_ENABLE_STATS
+#include <atomic>
+#include <combinable.hpp>
+#endif // CONCURRENT_ENABLE_STATS
+
+namespace concurrent {
+
+    /// <summary>
+    /// Snapshot of a container's hot-path counters, returned by its stats(). Counting is compiled in only when
+    /// CONCURRENT_ENABLE_STATS is defined, otherwise the recorder is an empty member and every field reads 0.
+    /// The containers are lock-free, so contended_waits stands in for lock waits: it counts the times a thread
+    /// yielded while another one finished a slot or a segment it depends on. Storage bytes follow the segments,
+    /// so a container that hands its storage to another one stops holding it; event counts stay with the object
+    /// that recorded them.
+    /// </summary>
+    struct container_stats {
+        static constexpr bool enabled =
+#ifdef CONCURRENT_ENABLE_STATS
+            true;
+#else
+            false;
+#endif // CONCURRENT_ENABLE_STATS
+
+        std::uint64_t pushes { 0 };
+        std::uint64_t pops { 0 };
+        std::uint64_t failed_pops { 0 };
+        std::uint64_t segment_allocations { 0 };
+        std::uint64_t segment_recycles { 0 };
+        std::uint64_t bytes_allocated { 0 };
+        std::uint64_t bytes_released { 0 };
+        std::uint64_t contended_waits { 0 };
+
+        [[nodiscard]] constexpr std::uint64_t backlog() const noexcept { return pushes > pops ? pushes - pops : 0; }
+
+        [[nodiscard]] constexpr std::uint64_t bytes_held() const noexcept {
+            return bytes_allocated > bytes_released ? bytes_allocated - bytes_released : 0;
+        }
+    };
+
+    namespace impl {
+
+#ifdef CONCURRENT_ENABLE_STATS
+        /// <summary>
+        /// Counts into per-thread shards of a combinable, so recording is a plain store to a line no other
+        /// thread writes. Snapshots may run concurrently and sum the shards, each read on its own is exact.
+        /// </summary>
+        class Stats_recorder {
+            // Written by its owning thread only, the relaxed atomics make concurrent snapshots well-defined
+            struct Counter {
+                std::atomic< std::uint64_t > mValue { 0 };
+
+                Counter() noexcept = default;
+                Counter(const Counter &rhs) noexcept : mValue(rhs.load()) {}
+                Counter &operator=(const Counter &rhs) noexcept {
+                    mValue.store(rhs.load(), std::memory_order_relaxed);
+                    return *this;
+                }
+
+                void add(const std::uint64_t count) noexcept {
+                    mValue.store(mValue.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+                }
+                [[nodiscard]] std::uint64_t load() const noexcept { return mValue.load(std::memory_order_relaxed); }
+            };
+
+            struct Shard {
+                Counter mPushes;
+                Counter mPops;
+                Counter mFailedPops;
+                Counter mSegmentAllocations;
+                Counter mSegmentRecycles;
+                Counter mBytesAllocated;
+                Counter mBytesReleased;
+                Counter mContendedWaits;
+            };
+
+          public:
+            void Count_push(const std::uint64_t count = 1) const noexcept { Record(&Shard::mPushes, count); }
+            void Count_pop(const std::uint64_t count = 1) const noexcept { Record(&Shard::mPops, count); }
+            void Count_failed_pop() const noexcept { Record(&Shard::mFailedPops, 1); }
+            void Count_recycle() const noexcept { Record(&Shard::mSegmentRecycles, 1); }
+            void Count_contended_wait() const noexcept { Record(&Shard::mContendedWaits, 1); }
+
+            void Count_allocation(const std::size_t bytes) const noexcept {
+                Record(&Shard::mSegmentAllocations, 1);
+                Record(&Shard::mBytesAllocated, bytes);
+            }
+            void Count_release(const std::size_t bytes) const noexcept { Record(&Shard::mBytesReleased, bytes); }
+
+            // Bytes handed over by another container, they are held here now without a new allocation
+            void Count_adoption(const std::size_t bytes) const noexcept { Record(&Shard::mBytesAllocated, bytes); }
+
+            [[nodiscard]] container_stats Snapshot() const {
+                container_stats stats {};
+                mShards.combine_each([&stats](const Shard &shard) {
+                    stats.pushes += shard.mPushes.load();
+                    stats.pops += shard.mPops.load();
+                    stats.failed_pops += shard.mFailedPops.load();
+                    stats.segment_allocations += shard.mSegmentAllocations.load();
+                    stats.segment_recycles += shard.mSegmentRecycles.load();
+                    stats.bytes_allocated += shard.mBytesAllocated.load();
+                    stats.bytes_released += shard.mBytesReleased.load();
+                    stats.contended_waits += shard.mContendedWaits.load();
+                });
+                return stats;
+            }
+
+          private:
+            // A shard that can not be allocated drops the sample, recording never throws
+            void Record(Counter Shard::*counter, const std::uint64_t count) const noexcept {
+                try {
+                    (mShards.local().*counter).add(count);
+                } catch (...) {
+                }
+            }
+
+            mutable combinable< Shard > mShards {};
+        };
+#else
+        class Stats_recorder {
+          public:
+            constexpr void Count_push(const std::uint64_t = 1) const noexcept {}
+            constexpr void Count_pop(const std::uint64_t = 1) const noexcept {}
+            constexpr void Count_failed_pop() const noexcept {}
+            constexpr void Count_recycle() const noexcept {}
+            constexpr void Count_contended_wait() const noexcept {}
+            constexpr void Count_allocation(const std::size_t) const noexcept {}
+            constexpr void Count_release(const std::size_t) const noexcept {}
+            constexpr void Count_adoption(const std::size_t) const noexcept {}
+
+            [[nodiscard]] constexpr container_stats Snapshot() const noexcept { return container_stats {}; }
+        };
+#endif // CONCURRENT_ENABLE_STATS
+
+    } // namespace impl
+} // namespace concurrent
+
+#endif // CONTAINER_STATS_HPP
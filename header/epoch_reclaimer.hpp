@@ -0,0 +1,159 @@
+#ifndef EPOCH_RECLAIMER_HPP
+#define EPOCH_RECLAIMER_HPP
+
+#include <atomic>
+#include <cassert>
+#include <combinable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace concurrent {
+
+    namespace impl {
+
+        using epoch_type = std::uint64_t;
+
+        /// <summary>
+        /// Epoch-based reclamation of the nodes a lock-free container unlinks while other threads may still be
+        /// reading them. Every operation runs inside a Guard, which announces the global epoch it started in.
+        /// A node retired in epoch e can not be reached by a guard that starts in e + 1, so it is handed to
+        /// Reclaim once the epoch has advanced twice; the epoch only advances when every active guard has
+        /// caught up with it.
+        /// Retired nodes wait on a list private to the retiring thread and are collected in batches of
+        /// BatchSize when that thread leaves its outermost guard, so a retire is two stores and freeing runs
+        /// off the operation. Threads that are idle or gone hold nothing back, memory stays bounded by the
+        /// batches unless a thread stalls inside an operation.
+        /// Node needs a Node *mRetiredNext and an epoch_type mRetireEpoch for the reclaimer's use.
+        /// </summary>
+        template < class Node, class Reclaim, std::size_t BatchSize = 32 >
+        class Epoch_reclaimer {
+            static_assert(BatchSize != 0, "Epoch_reclaimer needs a batch of at least one node");
+
+            struct Record {
+                Record() noexcept = default;
+                Record(const Record &) noexcept {} // combinable copies a fresh record into every thread's unit
+                Record &operator=(const Record &) = delete;
+
+                std::atomic< epoch_type > mAnnounced { 0 }; // Epoch << 1 | 1 while inside a guard, 0 outside
+
+                // Owner thread only, the limbo list holds the newest node first
+                std::size_t mDepth { 0 };
+                Node *      mLimbo { nullptr };
+                std::size_t mLimboCount { 0 };
+                std::size_t mNextCollect { BatchSize };
+            };
+
+          public:
+            // Re-entrant, must be left on the thread that entered it
+            class Guard {
+              public:
+                explicit Guard(const Epoch_reclaimer &reclaimer) : mOwner(reclaimer), mRecord(reclaimer.Enter()) {}
+                ~Guard() { mOwner.Leave(mRecord); }
+
+                Guard(const Guard &) = delete;
+                Guard &operator=(const Guard &) = delete;
+
+              private:
+                const Epoch_reclaimer &mOwner;
+                Record &               mRecord;
+            };
+
+            explicit Epoch_reclaimer(Reclaim reclaim) noexcept : mReclaim(std::move(reclaim)) {}
+
+            Epoch_reclaimer(const Epoch_reclaimer &) = delete;
+            Epoch_reclaimer &operator=(const Epoch_reclaimer &) = delete;
+
+            // Call inside a Guard on the unlinking thread, once the node can no longer be reached from the container
+            void Retire(Node *node) const noexcept {
+                auto &record = mRecords.local(); // Registered by the guard already, so nothing allocates
+                assert(record.mDepth != 0 && "Retire must run inside a guard");
+
+                // Collected by the outermost guard on its way out
+                node->mRetireEpoch = mEpoch.load();
+                node->mRetiredNext = std::exchange(record.mLimbo, node);
+                ++record.mLimboCount;
+            }
+
+            // Not concurrency-safe, hands every node still waiting to Reclaim
+            void Drain() noexcept {
+                mRecords.combine_each([this](const Record &record) {
+                    auto &owned        = const_cast< Record & >(record);
+                    auto  node         = std::exchange(owned.mLimbo, nullptr);
+                    owned.mLimboCount  = 0;
+                    owned.mNextCollect = BatchSize;
+                    Reclaim_list(node);
+                });
+            }
+
+          private:
+            Record &Enter() const {
+                auto &record = mRecords.local();
+                if (record.mDepth++ == 0) {
+                    // Sequentially consistent, so no pointer the operation loads is read before the announcement
+                    record.mAnnounced.store(mEpoch.load() << 1 | 1);
+                }
+                return record;
+            }
+
+            void Leave(Record &record) const noexcept {
+                if (--record.mDepth != 0) {
+                    return;
+                }
+
+                record.mAnnounced.store(0, std::memory_order_release);
+                if (record.mLimboCount >= record.mNextCollect) {
+                    Collect(record);
+                }
+            }
+
+            // Advances the epoch if every active guard announced the current one
+            bool Try_advance() const noexcept {
+                auto       epoch     = mEpoch.load();
+                const auto announced = epoch << 1 | 1;
+
+                auto lagging = false;
+                mRecords.combine_each([announced, &lagging](const Record &record) {
+                    const auto state = record.mAnnounced.load();
+                    lagging          = lagging || (state != 0 && state != announced);
+                });
+                return !lagging && mEpoch.compare_exchange_strong(epoch, epoch + 1);
+            }
+
+            // Outside any guard of this thread: with the other threads idle both advances succeed and the whole
+            // batch is reclaimed at once, otherwise the rest waits for a later batch
+            void Collect(Record &record) const noexcept {
+                if (Try_advance()) {
+                    Try_advance();
+                }
+
+                const auto safe = mEpoch.load();
+                auto       link = &record.mLimbo;
+                auto       kept = std::size_t { 0 };
+                while (*link && (*link)->mRetireEpoch + 2 > safe) {
+                    link = &(*link)->mRetiredNext;
+                    ++kept;
+                }
+
+                const auto expired  = std::exchange(*link, nullptr);
+                record.mLimboCount  = kept;
+                record.mNextCollect = kept + BatchSize;
+                Reclaim_list(expired);
+            }
+
+            void Reclaim_list(Node *node) const noexcept {
+                while (node) {
+                    mReclaim(std::exchange(node, node->mRetiredNext));
+                }
+            }
+
+            alignas(Cache_line_size) mutable std::atomic< epoch_type > mEpoch { 1 };
+            mutable combinable< Record > mRecords {};
+
+            [[no_unique_address]] Reclaim mReclaim;
+        };
+
+    } // namespace impl
+} // namespace concurrent
+
+#endif // EPOCH_RECLAIMER_HPP
@@ -0,0 +1,174 @@
+#ifndef SEGMENT_POOL_HPP
+#define SEGMENT_POOL_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <utils.h>
+
+namespace concurrent {
+
+    /// <summary>
+    /// Memory resource that keeps freed segment blocks for reuse instead of handing them back upstream.
+    /// Requests are rounded up to power-of-two size classes and cached in free lists sharded by thread,
+    /// so a container churning through segments under steady load stops reaching the upstream resource.
+    /// Containers draw their segment nodes and element blocks from their allocator, so passing the pool
+    /// through std::pmr::polymorphic_allocator pools both.
+    /// </summary>
+    class segment_pool : public std::pmr::memory_resource {
+        static constexpr std::size_t Min_block_size = impl::Cache_line_size;
+        static constexpr std::size_t Class_count    = 27; // Largest pooled block is Min_block_size << 26
+        static constexpr std::size_t Shard_count    = 8;
+
+        struct Free_block {
+            Free_block *mNext;
+        };
+
+        struct alignas(impl::Cache_line_size) Shard {
+            std::mutex                              mMutex;
+            std::array< Free_block *, Class_count > mFree {};
+        };
+
+      public:
+        // The upstream resource only sees pool misses, calls to it are serialised so an arena such as
+        // std::pmr::monotonic_buffer_resource can back the pool directly
+        explicit segment_pool(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) noexcept :
+            mUpstream(upstream) {}
+
+        segment_pool(const segment_pool &) = delete;
+        segment_pool &operator=(const segment_pool &) = delete;
+
+        ~segment_pool() override { release(); }
+
+        // Freed blocks that would grow the cache past this many bytes go straight back upstream
+        void set_retention_limit(const std::size_t bytes) noexcept { mRetentionLimit.store(bytes); }
+
+        [[nodiscard]] std::size_t retention_limit() const noexcept { return mRetentionLimit.load(); }
+
+        [[nodiscard]] std::size_t retained_bytes() const noexcept { return mRetainedBytes.load(); }
+
+        // Most bytes the cache ever held at once, a starting point for set_retention_limit
+        [[nodiscard]] std::size_t retained_high_water_mark() const noexcept { return mRetainedHighWaterMark.load(); }
+
+        [[nodiscard]] std::pmr::memory_resource *upstream_resource() const noexcept { return mUpstream; }
+
+        // Hands every cached block back upstream
+        void release() noexcept {
+            for (auto &shard : mShards) {
+                std::scoped_lock guard { shard.mMutex };
+                for (std::size_t size_class = 0; size_class < Class_count; ++size_class) {
+                    auto block = std::exchange(shard.mFree[size_class], nullptr);
+                    while (block) {
+                        auto to_release = block;
+                        block           = block->mNext;
+                        mRetainedBytes.fetch_sub(Class_size(size_class));
+                        Upstream_deallocate(to_release, Class_size(size_class), Min_block_size);
+                    }
+                }
+            }
+        }
+
+      protected:
+        void *do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+            const auto size_class = Size_class_of(bytes);
+            if (!Is_pooled(size_class, alignment)) {
+                return Upstream_allocate(bytes, alignment);
+            }
+
+            const auto home = Home_shard();
+            for (std::size_t i = 0; i < Shard_count; ++i) { // Steal from the other shards before going upstream
+                auto &shard = mShards[(home + i) % Shard_count];
+
+                std::scoped_lock guard { shard.mMutex };
+                if (auto block = shard.mFree[size_class]) {
+                    shard.mFree[size_class] = block->mNext;
+                    mRetainedBytes.fetch_sub(Class_size(size_class));
+                    return block;
+                }
+            }
+
+            return Upstream_allocate(Class_size(size_class), Min_block_size);
+        }
+
+        void do_deallocate(void *ptr, const std::size_t bytes, const std::size_t alignment) override {
+            const auto size_class = Size_class_of(bytes);
+            if (!Is_pooled(size_class, alignment)) {
+                Upstream_deallocate(ptr, bytes, alignment);
+                return;
+            }
+
+            const auto size     = Class_size(size_class);
+            const auto retained = mRetainedBytes.fetch_add(size) + size;
+            if (retained > mRetentionLimit.load()) {
+                mRetainedBytes.fetch_sub(size);
+                Upstream_deallocate(ptr, size, Min_block_size);
+                return;
+            }
+
+            auto high_water_mark = mRetainedHighWaterMark.load();
+            while (high_water_mark < retained &&
+                   !mRetainedHighWaterMark.compare_exchange_weak(high_water_mark, retained)) {
+            }
+
+            auto &shard = mShards[Home_shard()];
+            auto  block = ::new (ptr) Free_block { nullptr };
+
+            std::scoped_lock guard { shard.mMutex };
+            block->mNext            = shard.mFree[size_class];
+            shard.mFree[size_class] = block;
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == std::addressof(other);
+        }
+
+      private:
+        [[nodiscard]] static constexpr std::size_t Size_class_of(const std::size_t bytes) noexcept {
+            const auto blocks = (std::max(bytes, Min_block_size) + Min_block_size - 1) / Min_block_size;
+            return static_cast< std::size_t >(std::bit_width(blocks - 1));
+        }
+
+        [[nodiscard]] static constexpr std::size_t Class_size(const std::size_t size_class) noexcept {
+            return Min_block_size << size_class;
+        }
+
+        [[nodiscard]] static constexpr bool Is_pooled(const std::size_t size_class,
+                                                      const std::size_t alignment) noexcept {
+            return size_class < Class_count && alignment <= Min_block_size;
+        }
+
+        [[nodiscard]] static std::size_t Home_shard() noexcept {
+            return std::hash< std::thread::id > {}(std::this_thread::get_id()) % Shard_count;
+        }
+
+        void *Upstream_allocate(const std::size_t bytes, const std::size_t alignment) {
+            std::scoped_lock guard { mUpstreamMutex };
+            return mUpstream->allocate(bytes, alignment);
+        }
+
+        void Upstream_deallocate(void *ptr, const std::size_t bytes, const std::size_t alignment) noexcept {
+            std::scoped_lock guard { mUpstreamMutex };
+            mUpstream->deallocate(ptr, bytes, alignment);
+        }
+
+        std::array< Shard, Shard_count > mShards {};
+
+        std::atomic< std::size_t > mRetentionLimit { std::numeric_limits< std::size_t >::max() };
+        std::atomic< std::size_t > mRetainedBytes { 0 };
+        std::atomic< std::size_t > mRetainedHighWaterMark { 0 };
+
+        std::pmr::memory_resource *mUpstream;
+        std::mutex                 mUpstreamMutex;
+    };
+
+} // namespace concurrent
+
+#endif // SEGMENT_POOL_HPP
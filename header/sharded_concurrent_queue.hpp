@@ -0,0 +1,310 @@
+#ifndef SHARDED_CONCURRENT_QUEUE_HPP
+#define SHARDED_CONCURRENT_QUEUE_HPP
+
+#ifdef __linux__
+#include <sched.h>
+#endif // __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <concurrent_queue.hpp>
+#include <container_stats.hpp>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <utils.h>
+
+namespace concurrent {
+
+    namespace impl {
+
+        struct Cpu_location {
+            std::size_t mCpu;
+            std::size_t mNode;
+        };
+
+        // Threads numbered in the order they first asked, stands in for the CPU where it can not be read
+        inline std::size_t Thread_ordinal() noexcept {
+            static std::atomic< std::size_t > next_ordinal { 0 };
+            thread_local const auto           ordinal = next_ordinal.fetch_add(1, std::memory_order_relaxed);
+            return ordinal;
+        }
+
+        // CPU and NUMA node the calling thread runs on right now, the thread may migrate right after
+        inline Cpu_location Current_cpu_location() noexcept {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+            unsigned int cpu  = 0;
+            unsigned int node = 0;
+            if (getcpu(&cpu, &node) == 0) {
+                return Cpu_location { cpu, node };
+            }
+#endif
+            return Cpu_location { Thread_ordinal(), 0 };
+        }
+
+        // One past the highest NUMA node the kernel may bring online, 1 when the topology can not be read
+        inline std::size_t Numa_node_count() noexcept {
+            static const auto count = []() noexcept -> std::size_t {
+#ifdef __linux__
+                try {
+                    // A list of node ranges such as "0" or "0-1,3", the last number is the highest node
+                    std::ifstream possible { "/sys/devices/system/node/possible" };
+                    std::string   nodes {};
+                    if (std::getline(possible, nodes)) {
+                        const auto last_digit = nodes.find_last_of("0123456789");
+                        if (last_digit != std::string::npos) {
+                            const auto first_digit = nodes.find_last_not_of("0123456789", last_digit) + 1;
+                            return std::stoul(nodes.substr(first_digit, last_digit - first_digit + 1)) + 1;
+                        }
+                    }
+                } catch (...) {
+                }
+#endif // __linux__
+                return 1;
+            }();
+            return count;
+        }
+
+    } // namespace impl
+
+    /// <summary>
+    /// Shard selector with one shard per NUMA node, the calling thread uses the shard of the node it runs on.
+    /// A selector tells a sharded_concurrent_queue how many shards to build and which one belongs to the calling
+    /// thread. shard_count is asked once on construction, current_shard on every operation and taken modulo the
+    /// shard count, so it has to be cheap.
+    /// </summary>
+    struct numa_node_shards {
+        [[nodiscard]] std::size_t shard_count() const noexcept { return impl::Numa_node_count(); }
+        [[nodiscard]] std::size_t current_shard() const noexcept { return impl::Current_cpu_location().mNode; }
+    };
+
+    // One shard per group of cores_per_shard consecutive logical CPUs
+    class core_group_shards {
+      public:
+        explicit core_group_shards(const std::size_t cores_per_shard) noexcept :
+            mCoresPerShard(std::max< std::size_t >(cores_per_shard, 1)) {}
+
+        [[nodiscard]] std::size_t shard_count() const noexcept {
+            const auto cores = std::max< std::size_t >(std::thread::hardware_concurrency(), 1);
+            return (cores + mCoresPerShard - 1) / mCoresPerShard;
+        }
+
+        [[nodiscard]] std::size_t current_shard() const noexcept {
+            return impl::Current_cpu_location().mCpu / mCoresPerShard;
+        }
+
+      private:
+        std::size_t mCoresPerShard;
+    };
+
+    /// <summary>
+    /// Queue split into one concurrent_queue per shard, by default one per NUMA node, so the head and tail of
+    /// a shard are only written by the cores of one node. Producers push to the shard of the CPU they run on,
+    /// consumers pop from their own shard first and steal from the others, in a fixed rotation, once it is
+    /// empty.
+    /// Each shard is FIFO on its own: elements pushed to one shard leave it in push order. Across shards there
+    /// is no order, and a producer that migrates to another node mid-stream continues on that node's shard.
+    /// Every shard gets its own allocator, from a factory called with the shard index, so an allocator bound to
+    /// the memory of that node can be supplied. With the default allocator segments are allocated and first
+    /// touched by the producers of the shard, which places them on the local node under the default policy.
+    /// </summary>
+    template < class Type, class ShardSelector = numa_node_shards, class Allocator = std::allocator< Type > >
+    class sharded_concurrent_queue {
+        static_assert(std::is_same_v< Type, typename Allocator::value_type >,
+                      CONCURRENT_QUEUE_ALLOCATOR_ERROR_MESSAGE("sharded_concurrent_queue<T, ShardSelector, Allocator>",
+                                                               "T"));
+
+      public:
+        using value_type      = Type;
+        using allocator_type  = Allocator;
+        using shard_selector  = ShardSelector;
+        using shard_type      = concurrent_queue< Type, Allocator >;
+        using size_type       = typename shard_type::size_type;
+        using difference_type = typename shard_type::difference_type;
+        using reference       = Type &;
+        using const_reference = const Type &;
+
+      private:
+        struct alignas(impl::Cache_line_size) Shard {
+            explicit Shard(const allocator_type &allocator) : mQueue(allocator) {}
+
+            shard_type mQueue;
+        };
+
+        // Only the small shard objects live here, the elements are in the segments the shards allocate
+        using shard_allocator    = std::allocator< Shard >;
+        using shard_alloc_traits = std::allocator_traits< shard_allocator >;
+
+      public:
+        explicit sharded_concurrent_queue(const allocator_type &allocator = allocator_type {}) :
+            sharded_concurrent_queue(ShardSelector {}, allocator) {}
+
+        explicit sharded_concurrent_queue(ShardSelector selector, const allocator_type &allocator = allocator_type {}) :
+            sharded_concurrent_queue(std::move(selector), [&allocator](size_type) { return allocator; }) {}
+
+        // make_allocator(shard) returns the allocator of that shard
+        template < class AllocatorFactory >
+        requires(std::is_invocable_r_v< allocator_type, AllocatorFactory &, size_type >)
+            sharded_concurrent_queue(ShardSelector selector, AllocatorFactory make_allocator) :
+            mSelector(std::move(selector)),
+            mShardCount(std::max< size_type >(static_cast< size_type >(mSelector.shard_count()), 1)) {
+            mShards = shard_alloc_traits::allocate(mShardAllocator, mShardCount);
+
+            size_type constructed = 0;
+            try {
+                for (; constructed < mShardCount; ++constructed) {
+                    shard_alloc_traits::construct(mShardAllocator, mShards + constructed,
+                                                  static_cast< allocator_type >(make_allocator(constructed)));
+                }
+            } catch (...) {
+                Destroy_shards(constructed);
+                throw;
+            }
+        }
+
+        sharded_concurrent_queue(const sharded_concurrent_queue &) = delete;
+        sharded_concurrent_queue &operator=(const sharded_concurrent_queue &) = delete;
+
+        ~sharded_concurrent_queue() { Destroy_shards(mShardCount); }
+
+        /// Modifiers - concurrency-safe
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        void push(const Type &value) { Local_shard().push(value); }
+
+        void push(Type &&value) { Local_shard().push(std::move(value)); }
+
+        template < class... Args >
+        void emplace(Args &&...args) {
+            Local_shard().emplace(std::forward< Args >(args)...);
+        }
+
+        // The whole range goes to the caller's shard and keeps its order
+        template < class InputIt >
+        requires(traits::legacy_input_iterator< InputIt >) void push_range(InputIt first, InputIt last) {
+            Local_shard().push_range(first, last);
+        }
+
+        bool try_pop(Type &dest) {
+            auto element = try_pop();
+            if (!element) {
+                dest = Type {};
+                return false;
+            }
+            dest = std::move(*element);
+            return true;
+        }
+
+        std::optional< Type > try_pop() {
+            const auto local = Local_shard_index();
+            for (size_type offset = 0; offset < mShardCount; ++offset) {
+                if (auto element = mShards[Rotate(local, offset)].mQueue.try_pop()) {
+                    return element;
+                }
+            }
+            return std::nullopt;
+        }
+
+        // Fills up from the caller's shard first, then from the others, returns how many elements were popped
+        template < class OutputIt >
+        size_type try_pop_bulk(OutputIt dest, const size_type max_count) {
+            const auto local  = Local_shard_index();
+            size_type  popped = 0;
+            for (size_type offset = 0; offset < mShardCount && popped < max_count; ++offset) {
+                auto &shard = mShards[Rotate(local, offset)].mQueue;
+                if (!shard.empty()) {
+                    // Passed by reference, so the next shard goes on writing where this one stopped
+                    popped += shard.template try_pop_bulk< OutputIt & >(dest, max_count - popped);
+                }
+            }
+            return popped;
+        }
+
+        /// Capacity - concurrency-safe, the result may already be stale
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        [[nodiscard]] bool empty() const {
+            return std::all_of(mShards, mShards + mShardCount, [](const Shard &shard) { return shard.mQueue.empty(); });
+        }
+
+        [[nodiscard]] size_type size_hint() const {
+            size_type size = 0;
+            for (size_type index = 0; index < mShardCount; ++index) {
+                size += mShards[index].mQueue.size_hint();
+            }
+            return size;
+        }
+
+        [[nodiscard]] size_type shard_count() const noexcept { return mShardCount; }
+
+        // Index of the shard the calling thread pushes to and pops from first
+        [[nodiscard]] size_type current_shard() const noexcept { return Local_shard_index(); }
+
+        // Direct access to one shard, e.g. to keep a producer on a shard after it migrated
+        [[nodiscard]] shard_type &shard(const size_type index) noexcept { return mShards[index].mQueue; }
+
+        [[nodiscard]] const shard_type &shard(const size_type index) const noexcept { return mShards[index].mQueue; }
+
+        // Concurrency-safe, the counters of all shards added up. A pop that had to probe empty shards before it
+        // found an element counts a failed pop for each of them
+        [[nodiscard]] container_stats stats() const {
+            container_stats total {};
+            for (size_type index = 0; index < mShardCount; ++index) {
+                const auto stats = mShards[index].mQueue.stats();
+                total.pushes += stats.pushes;
+                total.pops += stats.pops;
+                total.failed_pops += stats.failed_pops;
+                total.segment_allocations += stats.segment_allocations;
+                total.segment_recycles += stats.segment_recycles;
+                total.bytes_allocated += stats.bytes_allocated;
+                total.bytes_released += stats.bytes_released;
+                total.contended_waits += stats.contended_waits;
+            }
+            return total;
+        }
+
+        /// Not concurrency-safe
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        void clear() {
+            for (size_type index = 0; index < mShardCount; ++index) {
+                mShards[index].mQueue.clear();
+            }
+        }
+
+      private:
+        // A single shard skips asking the selector, which may cost a system call
+        [[nodiscard]] size_type Local_shard_index() const noexcept {
+            if (mShardCount == 1) {
+                return 0;
+            }
+            return static_cast< size_type >(mSelector.current_shard()) % mShardCount;
+        }
+
+        [[nodiscard]] shard_type &Local_shard() noexcept { return mShards[Local_shard_index()].mQueue; }
+
+        // The shard offset places after first, wrapping around
+        [[nodiscard]] size_type Rotate(const size_type first, const size_type offset) const noexcept {
+            const auto index = first + offset;
+            return index < mShardCount ? index : index - mShardCount;
+        }
+
+        void Destroy_shards(size_type count) noexcept {
+            while (count > 0) {
+                shard_alloc_traits::destroy(mShardAllocator, mShards + --count);
+            }
+            shard_alloc_traits::deallocate(mShardAllocator, mShards, mShardCount);
+        }
+
+        [[no_unique_address]] shard_selector  mSelector;
+        [[no_unique_address]] shard_allocator mShardAllocator {};
+        size_type                             mShardCount;
+        Shard *                               mShards { nullptr };
+    };
+
+} // namespace concurrent
+
+#endif // SHARDED_CONCURRENT_QUEUE_HPP
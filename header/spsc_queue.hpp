@@ -0,0 +1,219 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <utils.h>
+
+namespace concurrent {
+
+    /// <summary>
+    /// Unbounded queue for exactly one producer thread and one consumer thread. Like concurrent_queue it is
+    /// a chain of segments, but each side owns its position outright: the producer publishes how far a
+    /// segment is written with a release store and the consumer caches the last count it acquired, so an
+    /// operation costs no read-modify-write and touches the other side's cache line only when it runs dry.
+    /// </summary>
+    template < class Type, class Allocator = std::allocator< Type > >
+    class spsc_queue {
+        static_assert(std::is_same_v< Type, typename Allocator::value_type >,
+                      "spsc_queue<T, Allocator> requires its allocator type to match T");
+
+      private:
+        using allocator_traits = std::allocator_traits< Allocator >;
+
+      public:
+        using value_type      = Type;
+        using allocator_type  = Allocator;
+        using size_type       = typename allocator_traits::size_type;
+        using difference_type = typename allocator_traits::difference_type;
+        using reference       = Type &;
+        using const_reference = const Type &;
+
+      private:
+        struct Segment {
+            value_type *             mElements { nullptr };
+            std::atomic< Segment * > mNextSegment { nullptr };
+
+            // Sole field the producer writes while the consumer reads the segment
+            alignas(impl::Cache_line_size) std::atomic< size_type > mWritten { 0 };
+        };
+
+        using segment_allocator        = typename allocator_traits::template rebind_alloc< Segment >;
+        using segment_allocator_traits = std::allocator_traits< segment_allocator >;
+
+        // Segments never grow, they start at 32 initial segments worth of elements within segment_traits' limits
+        using segment_sizing = impl::Segment_sizing< Type, size_type >;
+
+        static constexpr size_type Segment_capacity = segment_sizing::Segment_size(segment_sizing::Initial_size * 32);
+
+      public:
+        explicit spsc_queue(const allocator_type &allocator = allocator_type {}) : mAllocator(allocator) {
+            mConsumer.mHead = mProducer.mTail = Allocate_segment();
+        }
+
+        spsc_queue(const spsc_queue &) = delete;
+        spsc_queue &operator=(const spsc_queue &) = delete;
+
+        ~spsc_queue() { Finalise(); }
+
+        allocator_type get_allocator() const { return mAllocator; }
+
+        // Producer thread only
+        void push(const Type &value) { emplace(value); }
+
+        // Producer thread only
+        void push(Type &&value) { emplace(std::move(value)); }
+
+        // Producer thread only
+        template < class... Args >
+        void emplace(Args &&...args) {
+            if (mProducer.mTailIndex == Segment_capacity) {
+                Append_segment();
+            }
+
+            const auto tail = mProducer.mTail;
+            allocator_traits::construct(mAllocator, unfancy_ptr(tail->mElements + mProducer.mTailIndex),
+                                        std::forward< Args >(args)...);
+            tail->mWritten.store(++mProducer.mTailIndex, std::memory_order_release);
+        }
+
+        // Consumer thread only
+        bool try_pop(Type &dest) {
+            if (!Has_element()) {
+                return false;
+            }
+
+            const auto element = mConsumer.mHead->mElements + mConsumer.mHeadIndex;
+            dest               = std::move(*element);
+            allocator_traits::destroy(mAllocator, unfancy_ptr(element));
+            ++mConsumer.mHeadIndex;
+            return true;
+        }
+
+        // Consumer thread only
+        [[nodiscard]] bool empty() { return !Has_element(); }
+
+        // Not concurrency-safe
+        void clear() {
+            while (Has_element()) {
+                allocator_traits::destroy(mAllocator,
+                                          unfancy_ptr(mConsumer.mHead->mElements + mConsumer.mHeadIndex++));
+            }
+        }
+
+      private:
+        // Moves the consumer onto the next readable element, refreshing the cached count only when it ran out
+        bool Has_element() {
+            if (mConsumer.mHeadIndex != mConsumer.mCachedWritten) {
+                return true;
+            }
+
+            mConsumer.mCachedWritten = mConsumer.mHead->mWritten.load(std::memory_order_acquire);
+            if (mConsumer.mHeadIndex != mConsumer.mCachedWritten) {
+                return true;
+            }
+
+            if (mConsumer.mHeadIndex != Segment_capacity) {
+                return false;
+            }
+
+            const auto next = mConsumer.mHead->mNextSegment.load(std::memory_order_acquire);
+            if (!next) {
+                return false;
+            }
+
+            Recycle_segment(std::exchange(mConsumer.mHead, next));
+            mConsumer.mHeadIndex     = 0;
+            mConsumer.mCachedWritten = next->mWritten.load(std::memory_order_acquire);
+            return mConsumer.mCachedWritten != 0;
+        }
+
+        void Append_segment() {
+            auto segment = mSpareSegment.exchange(nullptr, std::memory_order_acquire);
+            if (segment) {
+                segment->mWritten.store(0, std::memory_order_relaxed);
+                segment->mNextSegment.store(nullptr, std::memory_order_relaxed);
+            } else {
+                segment = Allocate_segment();
+            }
+
+            mProducer.mTail->mNextSegment.store(segment, std::memory_order_release);
+            mProducer.mTail      = segment;
+            mProducer.mTailIndex = 0;
+        }
+
+        // Drained segments are handed back to the producer through a single spare slot
+        void Recycle_segment(Segment *segment) noexcept {
+            if (auto previous = mSpareSegment.exchange(segment, std::memory_order_acq_rel)) {
+                Deallocate_segment(previous);
+            }
+        }
+
+        Segment *Allocate_segment() {
+            auto alloc   = segment_allocator { mAllocator };
+            auto segment = alloc.allocate(1);
+            segment_allocator_traits::construct(alloc, segment);
+
+            try {
+                segment->mElements = mAllocator.allocate(Segment_capacity);
+            } catch (...) {
+                segment_allocator_traits::destroy(alloc, segment);
+                alloc.deallocate(segment, 1);
+                throw;
+            }
+
+            return segment;
+        }
+
+        void Deallocate_segment(Segment *segment) noexcept {
+            mAllocator.deallocate(segment->mElements, Segment_capacity);
+
+            auto alloc = segment_allocator { mAllocator };
+            segment_allocator_traits::destroy(alloc, segment);
+            alloc.deallocate(segment, 1);
+        }
+
+        void Finalise() noexcept {
+            auto segment = mConsumer.mHead;
+            auto first   = mConsumer.mHeadIndex;
+            while (segment) {
+                const auto last = segment->mWritten.load(std::memory_order_acquire);
+                for (auto i = first; i < last; ++i) {
+                    allocator_traits::destroy(mAllocator, unfancy_ptr(segment->mElements + i));
+                }
+
+                auto to_delete = segment;
+                segment        = segment->mNextSegment.load(std::memory_order_acquire);
+                first          = 0;
+                Deallocate_segment(to_delete);
+            }
+
+            if (auto spare = mSpareSegment.exchange(nullptr)) {
+                Deallocate_segment(spare);
+            }
+        }
+
+        struct alignas(impl::Cache_line_size) Producer_side {
+            Segment * mTail { nullptr };
+            size_type mTailIndex { 0 };
+        };
+
+        struct alignas(impl::Cache_line_size) Consumer_side {
+            Segment * mHead { nullptr };
+            size_type mHeadIndex { 0 };
+            size_type mCachedWritten { 0 }; // Last mWritten of the head segment the consumer acquired
+        };
+
+        Producer_side mProducer {};
+        Consumer_side mConsumer {};
+
+        alignas(impl::Cache_line_size) std::atomic< Segment * > mSpareSegment { nullptr };
+
+        allocator_type mAllocator {};
+    };
+
+} // namespace concurrent
+
+#endif // SPSC_QUEUE_HPP
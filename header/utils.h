@@ -1,6 +1,16 @@
 #ifndef CONCURRENT_UTILS
 #define CONCURRENT_UTILS
 
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace concurrent {
 
     namespace traits {
@@ -26,6 +36,22 @@ namespace concurrent {
             alloc.destroy(type);
         };
 
+        // Checks if the allocator has its own construct function, without one elements may be built directly
+        template < class Allocator, class PtrType, class... Args >
+        concept has_construct = requires(Allocator alloc, PtrType type, Args &&...args) {
+            alloc.construct(type, std::forward< Args >(args)...);
+        };
+
+        // Elements the allocator would only copy bytes into can be copied in bulk with memcpy
+        template < class Allocator, class Type >
+        inline constexpr bool is_trivially_copy_constructed_v =
+            std::is_trivially_copyable_v< Type > && !has_construct< Allocator, Type *, const Type & >;
+
+        // Elements the allocator would not run any code for can be dropped without a destructor loop
+        template < class Allocator, class Type >
+        inline constexpr bool is_trivially_destroyed_v =
+            std::is_trivially_destructible_v< Type > && !has_destroy< Allocator, Type * >;
+
     } // namespace traits
 
     /// <summary>
@@ -48,7 +74,104 @@ namespace concurrent {
         return ptr;
     }
 
+    /// <summary>
+    /// Default executor of the parallel algorithms. An executor is called with a nullary task and
+    /// returns a handle whose get() waits for the task, yielding its result or rethrowing its exception.
+    /// </summary>
+    struct async_executor {
+        template < class Task >
+        auto operator()(Task &&task) const {
+            return std::async(std::launch::async, std::forward< Task >(task));
+        }
+    };
+
     namespace impl {
+        /// <summary>
+        /// Runs chunk(0) to chunk(count - 1), chunk 0 on the calling thread and every other one as an executor task.
+        /// A task the executor fails to start runs on the calling thread instead. Waits for all of them, then
+        /// rethrows the first exception a chunk threw
+        /// </summary>
+        template < class Executor, class Chunk >
+        void Run_chunks(Executor &executor, const std::size_t count, const Chunk &chunk) {
+            using handle = decltype(executor([] {}));
+
+            std::vector< handle > tasks {};
+            std::exception_ptr    failure {};
+            const auto            run_here = [&chunk, &failure](const std::size_t index) noexcept {
+                try {
+                    chunk(index);
+                } catch (...) {
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+            };
+
+            auto started = std::size_t { 1 };
+            try {
+                tasks.reserve(count > 0 ? count - 1 : 0);
+                for (; started < count; ++started) {
+                    tasks.push_back(executor([&chunk, started]() { chunk(started); }));
+                }
+            } catch (...) {
+            }
+            for (auto index = started; index < count; ++index) {
+                run_here(index);
+            }
+            if (count > 0) {
+                run_here(0);
+            }
+
+            for (auto &task : tasks) {
+                try {
+                    task.get();
+                } catch (...) {
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+            }
+            if (failure) {
+                std::rethrow_exception(failure);
+            }
+        }
+
+        // Alignment that keeps independently written objects off each other's cache lines
+#ifdef __cpp_lib_hardware_interference_size
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size" // Only used for in-process layout, never across an ABI boundary
+#endif
+        inline constexpr std::size_t Cache_line_size = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+        inline constexpr std::size_t Cache_line_size = 64;
+#endif
+
+        /// <summary>
+        /// Geometric growth of MSVC's vector: 1.5 times the current capacity unless another factor is given,
+        /// at least new_size and min_size.
+        /// A container calls it when an element is pushed while it is full, so the current capacity is new_size - 1.
+        /// </summary>
+        template < class SizeType >
+        [[nodiscard]] constexpr SizeType Calculate_new_capacity(const SizeType new_size, const SizeType min_size,
+                                                                const std::size_t growth_numerator   = 3,
+                                                                const std::size_t growth_denominator = 2) noexcept {
+            constexpr auto size_limit       = std::numeric_limits< SizeType >::max();
+            const auto     current_capacity = new_size - 1;
+            const auto     ratio            = static_cast< SizeType >(growth_numerator - growth_denominator);
+            const auto     whole_parts      = current_capacity / static_cast< SizeType >(growth_denominator);
+
+            if (ratio != 0 && whole_parts > (size_limit - current_capacity) / ratio) {
+                return size_limit;
+            }
+
+            const SizeType size = current_capacity + whole_parts * ratio;
+            return std::max({ min_size, new_size, size });
+        }
+
         template < class EvalType, typename ReturnType >
         struct Min_segment_size_eval {
           private:
@@ -66,6 +189,75 @@ namespace concurrent {
             static constexpr ReturnType value = eval(0);
         };
     } // namespace impl
+
+    /// <summary>
+    /// Segment sizing of the segmented containers holding Type. Specialise it to tune every container of an
+    /// element type, fields left out of a specialisation can be taken from segment_traits_defaults< Type >.
+    /// Byte sizes are converted to whole elements, at least one.
+    /// </summary>
+    template < class Type >
+    struct segment_traits_defaults {
+        // First and smallest segment
+        static constexpr std::size_t initial_segment_bytes =
+            impl::Min_segment_size_eval< Type, std::size_t >::value * sizeof(Type);
+
+        // Growth factor of the capacity when a container runs full
+        static constexpr std::size_t growth_numerator   = 3;
+        static constexpr std::size_t growth_denominator = 2;
+
+        // No segment grows past this, a container keeps adding segments of this size instead
+        static constexpr std::size_t max_segment_bytes = std::numeric_limits< std::size_t >::max();
+
+        // Segments of at least this many bytes are rounded up to a multiple of it, e.g. 2MB for huge pages.
+        // 0 disables rounding
+        static constexpr std::size_t page_bytes = 0;
+    };
+
+    template < class Type >
+    struct segment_traits : segment_traits_defaults< Type > {};
+
+    namespace impl {
+        /// <summary>
+        /// segment_traits in the units of a container: element counts of its size_type
+        /// </summary>
+        template < class Type, class SizeType >
+        struct Segment_sizing {
+          private:
+            using traits = segment_traits< Type >;
+
+            static_assert(traits::growth_denominator != 0 && traits::growth_numerator > traits::growth_denominator,
+                          "segment_traits<T> must grow the capacity by a factor greater than 1");
+
+            static constexpr SizeType Elements_in(const std::size_t bytes) noexcept {
+                return static_cast< SizeType >(
+                    std::min< std::size_t >(std::max< std::size_t >(bytes / sizeof(Type), 1),
+                                            std::numeric_limits< SizeType >::max()));
+            }
+
+          public:
+            static constexpr SizeType Initial_size = Elements_in(traits::initial_segment_bytes);
+            static constexpr SizeType Max_size     = std::max(Initial_size, Elements_in(traits::max_segment_bytes));
+
+            // Total capacity once an element is pushed while new_size - 1 elements fill the container
+            [[nodiscard]] static constexpr SizeType New_capacity(const SizeType new_size) noexcept {
+                return Calculate_new_capacity(new_size, Initial_size, traits::growth_numerator,
+                                              traits::growth_denominator);
+            }
+
+            // Clamps a wanted segment length into [Initial_size, Max_size], then rounds it up to whole pages
+            [[nodiscard]] static constexpr SizeType Segment_size(const SizeType wanted) noexcept {
+                const auto size = std::clamp(wanted, Initial_size, Max_size);
+                if constexpr (traits::page_bytes != 0) {
+                    const auto bytes = static_cast< std::size_t >(size) * sizeof(Type);
+                    if (bytes >= traits::page_bytes) {
+                        const auto pages = (bytes + traits::page_bytes - 1) / traits::page_bytes;
+                        return Elements_in(pages * traits::page_bytes);
+                    }
+                }
+                return size;
+            }
+        };
+    } // namespace impl
 } // namespace concurrent
 
 #endif // CONCURRENT_UTILS
\ No newline at end of file
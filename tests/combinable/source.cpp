@@ -0,0 +1,129 @@
+#include <combinable.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+template < class Type >
+using T = concurrent::combinable< Type >;
+
+void test_local_is_stable() {
+    T< int > a {};
+    bool     exists = true;
+
+    auto &first = a.local(exists);
+    assert(!exists && first == 0);
+    first = 42;
+
+    [[maybe_unused]] auto &second = a.local(exists);
+    assert(exists && &first == &second && second == 42);
+    assert(reinterpret_cast< std::uintptr_t >(&first) % concurrent::impl::Cache_line_size == 0);
+}
+
+void test_local_per_instance() {
+    // More instances than thread cache entries, so lookups also go through the buckets
+    std::vector< T< int > > many(9);
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        many[i].local() = static_cast< int >(i);
+    }
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        assert(many[i].local() == static_cast< int >(i));
+        assert(many[i].combine([](int x, int y) { return x + y; }) == static_cast< int >(i));
+    }
+}
+
+void test_clear_resets_local() {
+    T< std::vector< int > > a {};
+    a.local().assign(100, 1);
+    a.clear();
+
+    bool                         exists    = true;
+    [[maybe_unused]] const auto &recreated = a.local(exists);
+    assert(recreated.empty() && !exists);
+    a.local().push_back(3);
+    assert(a.combine([](auto x, const auto &y) {
+        x.insert(x.end(), y.begin(), y.end());
+        return x;
+    }) == std::vector< int > { 3 });
+}
+
+void test_local_concurrent() {
+    constexpr int threads    = 32; // Far more threads than buckets, so registrations collide
+    constexpr int increments = 10000;
+
+    T< long long > a {};
+    bool           all_new = true;
+
+    std::vector< std::future< bool > > fn {};
+    for (auto i = 0; i < threads; ++i) {
+        fn.emplace_back(std::async(std::launch::async, [&a]() {
+            bool exists = true;
+            a.local(exists);
+            for (auto j = 0; j < increments; ++j) {
+                ++a.local();
+            }
+            return !exists;
+        }));
+    }
+    for (auto &f : fn) {
+        all_new = f.get() && all_new;
+    }
+
+    assert(all_new);
+    int units = 0;
+    a.combine_each([&units]([[maybe_unused]] long long value) {
+        assert(value == increments);
+        ++units;
+    });
+    assert(units == threads);
+    assert(a.combine([](long long x, long long y) { return x + y; }) == static_cast< long long >(threads) * increments);
+}
+
+void test_combine_parallel_and_into() {
+    constexpr int threads = 24;
+
+    T< std::vector< int > > a {};
+    assert(a.combine_parallel([](auto x, const auto &) { return x; }).empty());
+
+    std::vector< std::future< void > > fn {};
+    for (auto i = 0; i < threads; ++i) {
+        fn.emplace_back(std::async(std::launch::async, [&a, i]() { a.local().assign(100, i); }));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+
+    auto concat = [](std::vector< int > x, const std::vector< int > &y) {
+        x.insert(x.end(), y.begin(), y.end());
+        return x;
+    };
+    const auto serial   = a.combine(concat);
+    const auto parallel = a.combine_parallel(concat);
+    assert(serial.size() == threads * 100);
+    assert(parallel == serial); // Same left-to-right order
+
+    // Inline executor, every task runs on the calling thread
+    [[maybe_unused]] auto inline_executor = [](auto task) {
+        std::promise< decltype(task()) > promise {};
+        promise.set_value(task());
+        return promise.get_future();
+    };
+    assert(a.combine_parallel(concat, inline_executor) == serial);
+
+    std::vector< int > into {};
+    a.combine_into(into, [](std::vector< int > &result, const std::vector< int > &y) {
+        result.insert(result.end(), y.begin(), y.end());
+    });
+    assert(into == serial);
+}
+
+int main() {
+    test_local_is_stable();
+    test_local_per_instance();
+    test_clear_resets_local();
+    for (auto i = 0; i < 10; ++i) {
+        test_local_concurrent();
+    }
+    test_combine_parallel_and_into();
+}
@@ -0,0 +1,130 @@
+#include <concurrent_bounded_queue.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+template < class Type >
+using T = concurrent::concurrent_bounded_queue< Type >;
+
+void test_try_push_respects_capacity() {
+    T< int > a { 3 };
+    assert(a.capacity() == 3);
+    [[maybe_unused]] const auto filled = a.try_push(1) && a.try_push(2) && a.try_push(3);
+    [[maybe_unused]] const auto full   = !a.try_push(4);
+    assert(filled && full && a.size() == 3);
+
+    int                         v;
+    [[maybe_unused]] const auto popped = a.try_pop(v);
+    assert(popped && v == 1);
+    [[maybe_unused]] const auto refilled = a.try_push(4);
+    [[maybe_unused]] const auto overfull = a.try_push(5);
+    assert(refilled && !overfull);
+
+    for ([[maybe_unused]] auto expected : { 2, 3, 4 }) {
+        a.pop(v);
+        assert(v == expected);
+    }
+    [[maybe_unused]] const auto popped_empty = a.try_pop(v);
+    assert(a.empty() && a.size() == 0 && !popped_empty);
+}
+
+void test_try_pop_for() {
+    T< int > a { 1 };
+    int      v;
+
+    [[maybe_unused]] const auto start     = std::chrono::steady_clock::now();
+    [[maybe_unused]] const auto timed_out = !a.try_pop_for(v, std::chrono::milliseconds { 20 });
+    assert(timed_out && std::chrono::steady_clock::now() - start >= std::chrono::milliseconds { 20 });
+
+    auto producer = std::async(std::launch::async, [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds { 10 });
+        a.push(7);
+    });
+    [[maybe_unused]] const auto popped = a.try_pop_for(v, std::chrono::seconds { 10 });
+    assert(popped && v == 7);
+    producer.wait();
+}
+
+void test_blocking_push_and_set_capacity() {
+    T< int > a { 1 };
+    a.push(0);
+
+    std::atomic_bool pushed   = false;
+    auto             producer = std::async(std::launch::async, [&]() {
+        a.push(1);
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds { 20 });
+    assert(!pushed);
+
+    // Growing the capacity wakes the blocked producer
+    a.set_capacity(2);
+    producer.wait();
+    assert(pushed && a.size() == 2);
+
+    // Shrinking keeps producers blocked until the excess is drained
+    a.set_capacity(1);
+    [[maybe_unused]] const auto over_capacity = a.try_push(2);
+    int                         v;
+    a.pop(v);
+    [[maybe_unused]] const auto at_capacity = a.try_push(2);
+    a.pop(v);
+    [[maybe_unused]] const auto below_capacity = a.try_push(2);
+    assert(!over_capacity && !at_capacity && v == 1 && below_capacity);
+}
+
+void test_push_pop_concurrent() {
+    constexpr int producers  = 4;
+    constexpr int consumers  = 4;
+    constexpr int per_thread = 20000;
+
+    T< int >                 a { 16 };
+    std::atomic< long long > consumed_sum = 0;
+    std::atomic_bool         overflow     = false;
+
+    auto push = [&](int producer) {
+        for (auto i = 0; i < per_thread; ++i) {
+            a.push(producer * per_thread + i);
+            if (a.size() > a.capacity()) {
+                overflow = true;
+            }
+        }
+    };
+    auto pop = [&]() {
+        int v;
+        for (auto i = 0; i < per_thread; ++i) {
+            a.pop(v);
+            consumed_sum += v;
+        }
+    };
+
+    std::vector< std::future< void > > fn {};
+    for (auto i = 0; i < consumers; ++i) {
+        fn.emplace_back(std::async(std::launch::async, pop));
+    }
+    for (auto i = 0; i < producers; ++i) {
+        fn.emplace_back(std::async(std::launch::async, push, i));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+
+    [[maybe_unused]] constexpr long long total = static_cast< long long >(producers) * per_thread;
+    assert(!overflow);
+    assert(consumed_sum == total * (total - 1) / 2);
+    assert(a.empty() && a.size() == 0);
+}
+
+int main() {
+    test_try_push_respects_capacity();
+    test_try_pop_for();
+    test_blocking_push_and_set_capacity();
+    for (auto i = 0; i < 10; ++i) {
+        test_push_pop_concurrent();
+    }
+}
@@ -0,0 +1,200 @@
+#include <concurrent_priority_queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <future>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+struct Throwing_element {
+    int mValue;
+
+    Throwing_element(int value) : mValue(value) {}
+    Throwing_element(const Throwing_element &rhs) : mValue(rhs.mValue) {
+        if (mValue < 0) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+    Throwing_element(Throwing_element &&) noexcept = default;
+    Throwing_element &operator=(const Throwing_element &) = default;
+    Throwing_element &operator=(Throwing_element &&) noexcept = default;
+
+    bool operator<(const Throwing_element &rhs) const noexcept { return mValue < rhs.mValue; }
+};
+
+void test_pops_in_priority_order() {
+    concurrent::concurrent_priority_queue< int > queue {};
+    auto                                         value        = 0;
+    [[maybe_unused]] const auto                  popped_empty = queue.try_pop(value);
+    assert(queue.empty() && !popped_empty);
+
+    std::vector< int > input(1000);
+    std::iota(input.begin(), input.end(), 0);
+    std::shuffle(input.begin(), input.end(), std::mt19937 { 7 });
+    for (const auto element : input) {
+        queue.push(element);
+    }
+    assert(queue.size() == 1000);
+
+    for (auto expected = 999; expected >= 0; --expected) {
+        [[maybe_unused]] const auto popped = queue.try_pop(value);
+        assert(popped && value == expected);
+    }
+    [[maybe_unused]] const auto drained = !queue.try_pop(value);
+    assert(queue.empty() && drained);
+}
+
+void test_construction_and_compare() {
+    concurrent::concurrent_priority_queue< int, std::greater< int > > queue { 5, 3, 9, 1, 7 };
+    assert(queue.size() == 5);
+
+    auto copy  = queue;
+    auto value = 0;
+    for ([[maybe_unused]] const auto expected : { 1, 3, 5, 7, 9 }) {
+        [[maybe_unused]] const auto popped = queue.try_pop(value);
+        assert(popped && value == expected);
+    }
+    assert(copy.size() == 5);
+    [[maybe_unused]] const auto copy_popped = copy.try_pop(value);
+    assert(copy_popped && value == 1);
+
+    decltype(copy) other { 42 };
+    other.swap(copy);
+    assert(copy.size() == 1 && other.size() == 4);
+
+    auto moved = std::move(other);
+    assert(moved.size() == 4);
+    [[maybe_unused]] const auto popped = moved.try_pop(value);
+    assert(popped && value == 3);
+    moved.clear();
+    assert(moved.empty());
+
+    decltype(copy) source { 4, 8, 6 };
+    decltype(copy) target { 1 };
+    target = std::move(source);
+    assert(target.size() == 3 && source.empty());
+    for ([[maybe_unused]] const auto expected : { 4, 6, 8 }) {
+        [[maybe_unused]] const auto found = target.try_pop(value);
+        assert(found && value == expected);
+    }
+}
+
+void test_move_only_elements() {
+    struct Compare {
+        bool operator()(const std::unique_ptr< int > &lhs, const std::unique_ptr< int > &rhs) const noexcept {
+            return *lhs < *rhs;
+        }
+    };
+
+    concurrent::concurrent_priority_queue< std::unique_ptr< int >, Compare > queue {};
+    for (auto i = 0; i < 100; ++i) {
+        queue.emplace(new int(i % 10));
+    }
+
+    std::unique_ptr< int > top {};
+    [[maybe_unused]] const auto popped = queue.try_pop(top);
+    assert(popped && *top == 9);
+    assert(queue.size() == 99);
+}
+
+void test_failed_push_keeps_heap() {
+    concurrent::concurrent_priority_queue< Throwing_element > queue { 1, 4, 2 };
+
+    const Throwing_element bad { -1 };
+    [[maybe_unused]] auto  threw = false;
+    try {
+        queue.push(bad);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    assert(threw && queue.size() == 3);
+
+    Throwing_element value { 0 };
+    for ([[maybe_unused]] const auto expected : { 4, 2, 1 }) {
+        [[maybe_unused]] const auto popped = queue.try_pop(value);
+        assert(popped && value.mValue == expected);
+    }
+    assert(queue.empty());
+}
+
+void test_concurrent_push_then_pop() {
+    concurrent::concurrent_priority_queue< int > queue {};
+
+    constexpr auto thread_count = 4;
+    constexpr auto per_thread   = 10000;
+
+    std::vector< std::future< void > > producers {};
+    for (auto t = 0; t < thread_count; ++t) {
+        producers.push_back(std::async(std::launch::async, [&queue, t] {
+            for (auto i = 0; i < per_thread; ++i) {
+                queue.push(i * thread_count + t);
+            }
+        }));
+    }
+    for (auto &producer : producers) {
+        producer.get();
+    }
+    assert(queue.size() == thread_count * per_thread);
+
+    [[maybe_unused]] auto previous = thread_count * per_thread;
+    auto                  value    = 0;
+    while (queue.try_pop(value)) {
+        assert(value == previous - 1);
+        previous = value;
+    }
+    assert(previous == 0);
+}
+
+void test_concurrent_producers_and_consumers() {
+    concurrent::concurrent_priority_queue< int > queue {};
+
+    constexpr auto thread_count = 4;
+    constexpr auto per_thread   = 10000;
+
+    std::atomic< long long > popped_sum { 0 };
+    std::atomic< int >       popped { 0 };
+
+    std::vector< std::future< void > > workers {};
+    for (auto t = 0; t < thread_count; ++t) {
+        workers.push_back(std::async(std::launch::async, [&queue, t] {
+            for (auto i = 1; i <= per_thread; ++i) {
+                queue.push(i * thread_count + t);
+            }
+        }));
+        workers.push_back(std::async(std::launch::async, [&queue, &popped_sum, &popped] {
+            auto value = 0;
+            while (popped.load() < thread_count * per_thread) {
+                if (queue.try_pop(value)) {
+                    popped_sum += value;
+                    ++popped;
+                }
+            }
+        }));
+    }
+    for (auto &worker : workers) {
+        worker.get();
+    }
+
+    long long expected = 0;
+    for (auto t = 0; t < thread_count; ++t) {
+        for (auto i = 1; i <= per_thread; ++i) {
+            expected += i * thread_count + t;
+        }
+    }
+    assert(popped == thread_count * per_thread && popped_sum == expected && queue.empty());
+}
+
+int main() {
+    test_pops_in_priority_order();
+    test_construction_and_compare();
+    test_move_only_elements();
+    test_failed_push_keeps_heap();
+    for (auto i = 0; i < 5; ++i) {
+        test_concurrent_push_then_pop();
+        test_concurrent_producers_and_consumers();
+    }
+}
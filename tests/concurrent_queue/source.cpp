@@ -1,9 +1,19 @@
 //#include <concurrent_queue.h>
 #include <concurrent_queue.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <exception>
 #include <future>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <test_common.hpp>
 #include <thread>
 #include <vector>
@@ -121,10 +131,528 @@ void test_push_try_pop_multithread() {
     assert(a.empty());
 }
 
+void test_push_try_pop_concurrent() {
+    constexpr int producers          = 8;
+    constexpr int consumers          = 8;
+    constexpr int values_per_produce = MAX_GEN_VALUE / producers;
+
+    T< int >                 a {};
+    std::atomic_int          produced_count = 0;
+    std::atomic_int          consumed_count = 0;
+    std::atomic< long long > consumed_sum   = 0;
+
+    auto push = [&](int producer) {
+        for (auto i = 0; i < values_per_produce; ++i) {
+            a.push(producer * values_per_produce + i);
+        }
+        produced_count++;
+    };
+    auto pop = [&]() {
+        int       v;
+        long long sum = 0;
+        while (produced_count != producers || !a.empty()) {
+            if (a.try_pop(v)) {
+                sum += v;
+                consumed_count++;
+            }
+        }
+        consumed_sum += sum;
+    };
+
+    std::vector< std::future< void > > fn {};
+    for (auto i = 0; i < consumers; ++i) {
+        fn.emplace_back(std::async(std::launch::async, pop));
+    }
+    for (auto i = 0; i < producers; ++i) {
+        fn.emplace_back(std::async(std::launch::async, push, i));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+
+    [[maybe_unused]] constexpr long long total = static_cast< long long >(producers) * values_per_produce;
+    assert(consumed_count == total);
+    assert(consumed_sum == total * (total - 1) / 2);
+    assert(a.empty());
+}
+
+void test_push_range_try_pop_bulk() {
+    T< int > a {};
+
+    std::vector< int > batch(100);
+    for (auto round = 0; round < 50; ++round) {
+        for (auto i = 0; i < 100; ++i) {
+            batch[i] = round * 100 + i;
+        }
+        a.push_range(batch.begin(), batch.end());
+    }
+    assert(a.unsafe_size() == 5000);
+
+    std::vector< int > drained {};
+    while (a.try_pop_bulk(std::back_inserter(drained), 64) != 0) {
+    }
+
+    assert(drained.size() == 5000);
+    for (auto i = 0; i < 5000; ++i) {
+        assert(drained[i] == i);
+    }
+    assert(a.empty());
+
+    // Mixed with single element operations
+    a.push(-1);
+    a.push_range(batch.begin(), batch.begin() + 10);
+    int                         v;
+    [[maybe_unused]] const auto popped = a.try_pop(v);
+    assert(popped && v == -1);
+    std::array< int, 32 >       out {};
+    [[maybe_unused]] const auto bulk = a.try_pop_bulk(out.begin(), out.size());
+    assert(bulk == 10);
+    assert(out[0] == batch[0] && out[9] == batch[9]);
+}
+
+void test_push_range_try_pop_bulk_concurrent() {
+    constexpr int producers  = 4;
+    constexpr int consumers  = 4;
+    constexpr int batches    = 200;
+    constexpr int batch_size = 64;
+
+    T< int >                 a {};
+    std::atomic_int          produced_count = 0;
+    std::atomic_int          consumed_count = 0;
+    std::atomic< long long > consumed_sum   = 0;
+
+    auto push = [&](int producer) {
+        std::vector< int > batch(batch_size);
+        for (auto b = 0; b < batches; ++b) {
+            for (auto i = 0; i < batch_size; ++i) {
+                batch[i] = (producer * batches + b) * batch_size + i;
+            }
+            a.push_range(batch.begin(), batch.end());
+        }
+        produced_count++;
+    };
+    auto pop = [&]() {
+        std::array< int, batch_size > out {};
+        while (produced_count != producers || !a.empty()) {
+            const auto popped = a.try_pop_bulk(out.begin(), out.size());
+            for (std::size_t i = 0; i < popped; ++i) {
+                consumed_sum += out[i];
+            }
+            consumed_count += static_cast< int >(popped);
+        }
+    };
+
+    std::vector< std::future< void > > fn {};
+    for (auto i = 0; i < consumers; ++i) {
+        fn.emplace_back(std::async(std::launch::async, pop));
+    }
+    for (auto i = 0; i < producers; ++i) {
+        fn.emplace_back(std::async(std::launch::async, push, i));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+
+    [[maybe_unused]] constexpr long long total = static_cast< long long >(producers) * batches * batch_size;
+    assert(consumed_count == total);
+    assert(consumed_sum == total * (total - 1) / 2);
+}
+
+void test_size_bookkeeping() {
+    T< int > a {};
+    assert(a.unsafe_size() == 0 && a.size_hint() == 0);
+
+    for (auto i = 0; i < 1000; ++i) {
+        a.push(i);
+        assert(a.unsafe_size() == static_cast< std::size_t >(i + 1));
+    }
+
+    int v;
+    for (auto i = 0; i < 600; ++i) {
+        a.try_pop(v);
+    }
+    assert(a.unsafe_size() == 400);
+    assert(a.size_hint() == 400);
+
+    a.clear();
+    assert(a.unsafe_size() == 0);
+    a.push(1);
+    assert(a.size_hint() == 1);
+}
+
+void test_try_pop_moves() {
+    T< std::unique_ptr< int > > a {};
+    for (auto i = 0; i < 100; ++i) {
+        a.push(std::make_unique< int >(i));
+    }
+
+    std::unique_ptr< int >      v;
+    [[maybe_unused]] const auto moved = a.try_pop(v);
+    assert(moved && *v == 0);
+
+    auto popped = a.try_pop();
+    assert(popped && **popped == 1);
+
+    while (a.try_pop()) {
+    }
+    [[maybe_unused]] const auto drained = !a.try_pop().has_value();
+    assert(drained);
+
+    // Payload past the small string buffer
+    T< std::string > b {};
+    b.push(std::string(100, 'x'));
+    auto message = b.try_pop();
+    assert(message && *message == std::string(100, 'x'));
+}
+
+void test_segment_reuse() {
+    // Keeps only a few elements in flight, so drained segments are handed back to the tail
+    T< int > a {};
+    int      v;
+    for (auto i = 0; i < 100000; ++i) {
+        a.push(i);
+        a.push(i);
+        [[maybe_unused]] const auto first  = a.try_pop(v) && v == i;
+        [[maybe_unused]] const auto second = a.try_pop(v) && v == i;
+        assert(first && second);
+    }
+    assert(a.empty() && a.unsafe_size() == 0);
+}
+
+struct Capped_handle {
+    std::size_t mValue;
+};
+
+template <>
+struct concurrent::segment_traits< Capped_handle > : concurrent::segment_traits_defaults< Capped_handle > {
+    static constexpr std::size_t initial_segment_bytes = 64 * sizeof(Capped_handle);
+    static constexpr std::size_t growth_numerator      = 2;
+    static constexpr std::size_t growth_denominator    = 1;
+    static constexpr std::size_t max_segment_bytes     = 1024 * sizeof(Capped_handle);
+    static constexpr std::size_t page_bytes            = 512 * sizeof(Capped_handle);
+};
+
+void test_segment_traits() {
+    using sizing = concurrent::impl::Segment_sizing< Capped_handle, std::size_t >;
+    static_assert(sizing::Initial_size == 64 && sizing::Max_size == 1024);
+    static_assert(sizing::New_capacity(65) == 128);
+    static_assert(sizing::Segment_size(10) == 64 && sizing::Segment_size(600) == 1024);
+    static_assert(sizing::Segment_size(5000) == 1024);
+    static_assert(concurrent::impl::Segment_sizing< int, std::size_t >::Initial_size == 32); // Defaults kept
+
+    T< Capped_handle > a {};
+    for (std::size_t i = 0; i < 20000; ++i) {
+        a.push(Capped_handle { i });
+    }
+    assert(a.unsafe_size() == 20000);
+    for (std::size_t i = 0; i < 20000; ++i) {
+        [[maybe_unused]] auto handle = a.try_pop();
+        assert(handle && handle->mValue == i);
+    }
+    assert(a.empty());
+}
+
+// Fire-and-forget coroutine, runs until its first suspension inside the call
+struct Detached_task {
+    struct promise_type {
+        Detached_task       get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void                return_void() noexcept {}
+        void                unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+Detached_task consume_all(T< int > &queue, std::vector< int > &popped, std::atomic< bool > &finished) {
+    while (const auto value = co_await queue.async_pop()) {
+        popped.push_back(*value);
+    }
+    finished = true;
+}
+
+void test_async_pop() {
+    T< int >            a {};
+    std::vector< int >  popped {};
+    std::atomic< bool > finished { false };
+
+    a.push(1);
+    consume_all(a, popped, finished); // Takes the queued element without suspending, then parks
+    assert(popped == std::vector< int > { 1 } && !finished);
+
+    a.push(2);
+    a.push(3); // Both resumed the parked consumer before returning
+    assert((popped == std::vector< int > { 1, 2, 3 }) && a.empty());
+
+    const int range[] = { 4, 5 };
+    a.push_range(std::begin(range), std::end(range));
+    assert(popped.size() == 5 && popped.back() == 5);
+
+    a.close();
+    assert(finished && a.is_closed());
+
+    // A closed queue is still drained before async_pop reports the end
+    std::vector< int >  late {};
+    std::atomic< bool > late_finished { false };
+    a.push(6);
+    consume_all(a, late, late_finished);
+    assert(late == std::vector< int > { 6 } && late_finished);
+}
+
+void test_async_pop_concurrent() {
+    T< int > a {};
+
+    constexpr auto consumer_count = 4;
+    constexpr auto producer_count = 4;
+    constexpr auto per_producer   = 20000;
+
+    std::vector< std::vector< int > > popped(consumer_count);
+    std::vector< std::atomic< bool > > finished(consumer_count);
+    for (auto c = 0; c < consumer_count; ++c) {
+        consume_all(a, popped[c], finished[c]);
+    }
+
+    std::vector< std::future< void > > producers {};
+    for (auto p = 0; p < producer_count; ++p) {
+        producers.push_back(std::async(std::launch::async, [&a, p] {
+            for (auto i = 0; i < per_producer; ++i) {
+                a.push(p * per_producer + i);
+            }
+        }));
+    }
+    for (auto &producer : producers) {
+        producer.get();
+    }
+    a.close();
+
+    std::vector< int > all {};
+    for (auto c = 0; c < consumer_count; ++c) {
+        assert(finished[c]);
+        all.insert(all.end(), popped[c].begin(), popped[c].end());
+    }
+    // Whatever a consumer did not take before the close is still queued
+    while (const auto value = a.try_pop()) {
+        all.push_back(*value);
+    }
+    std::sort(all.begin(), all.end());
+    assert(all.size() == producer_count * per_producer);
+    for (auto i = 0; i < producer_count * per_producer; ++i) {
+        assert(all[i] == i);
+    }
+}
+
+struct Message {
+    static inline int constructions = 0;
+    static inline int copies        = 0;
+
+    int         mId;
+    std::string mBody;
+
+    Message(int id, std::string body) : mId(id), mBody(std::move(body)) {
+        if (id < 0) {
+            throw std::runtime_error("bad message");
+        }
+        ++constructions;
+    }
+    Message(const Message &rhs) : mId(rhs.mId), mBody(rhs.mBody) { ++copies; }
+    Message(Message &&) noexcept = default;
+    Message &operator=(const Message &) = default;
+    Message &operator=(Message &&) noexcept = default;
+};
+
+void test_emplace_and_reserve_slot() {
+    T< Message > a {};
+    a.emplace(1, "one");
+    assert(Message::constructions == 1 && Message::copies == 0);
+
+    {
+        auto slot = a.reserve_slot();
+        assert(!slot.has_value() && slot.get() == nullptr);
+        auto &message = slot.emplace(2, "");
+        message.mBody = "two"; // Filled in place after construction, e.g. by a decoder
+        assert(slot.get() == &message);
+        slot.commit();
+    }
+    {
+        auto slot = a.reserve_slot(); // Dropped without a commit, consumers skip it
+        slot.emplace(3, "dropped");
+    }
+    {
+        auto slot = a.reserve_slot();
+        slot.commit(); // Nothing was emplaced, the slot is given up as well
+    }
+    {
+        auto slot = a.reserve_slot();
+        try {
+            slot.emplace(-1, "");
+            assert(false);
+        } catch (const std::runtime_error &) {
+        }
+        slot.emplace(4, "four"); // The slot is still reserved after a throwing constructor
+        slot.commit();
+    }
+    assert(Message::copies == 0);
+
+    for ([[maybe_unused]] const auto expected : { 1, 2, 4 }) {
+        [[maybe_unused]] const auto message = a.try_pop();
+        assert(message && message->mId == expected);
+    }
+    [[maybe_unused]] const auto drained = !a.try_pop();
+    assert(drained && a.empty());
+}
+
+void test_reserved_slot_blocks_consumers() {
+    T< int > a {};
+    auto     slot = a.reserve_slot();
+
+    auto consumer = std::async(std::launch::async, [&a] {
+        int value = 0;
+        while (!a.try_pop(value)) { // Waits on the reserved slot once it drew its ticket
+        }
+        return value;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    slot.emplace(42);
+    slot.commit();
+    [[maybe_unused]] const auto consumed = consumer.get();
+    assert(consumed == 42);
+
+    // A parked coroutine is resumed by the commit
+    std::vector< int >  popped {};
+    std::atomic< bool > finished { false };
+    consume_all(a, popped, finished);
+    auto second = a.reserve_slot();
+    second.emplace(7);
+    assert(popped.empty());
+    second.commit();
+    assert(popped == std::vector< int > { 7 });
+    a.close();
+    assert(finished);
+}
+
+void test_reserve_slot_concurrent() {
+    T< int >   a {};
+    const auto producer_count = 4;
+    const auto per_producer   = 20000;
+
+    std::vector< std::future< void > > producers {};
+    for (auto p = 0; p < producer_count; ++p) {
+        producers.push_back(std::async(std::launch::async, [&a, p] {
+            for (auto i = 0; i < per_producer; ++i) {
+                auto slot = a.reserve_slot();
+                if (i % 3 == 0) {
+                    continue; // Abandoned
+                }
+                slot.emplace(p * per_producer + i);
+                slot.commit();
+            }
+        }));
+    }
+
+    std::vector< int > popped {};
+    auto               done = 0;
+    while (done < producer_count) {
+        done = 0;
+        for (auto &producer : producers) {
+            done += producer.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+        while (const auto value = a.try_pop()) {
+            popped.push_back(*value);
+        }
+    }
+    while (const auto value = a.try_pop()) {
+        popped.push_back(*value);
+    }
+
+    std::sort(popped.begin(), popped.end());
+    assert(std::adjacent_find(popped.begin(), popped.end()) == popped.end());
+    assert(popped.size() == static_cast< std::size_t >(producer_count * (per_producer - (per_producer + 2) / 3)));
+    for ([[maybe_unused]] const auto value : popped) {
+        assert(value % per_producer % 3 != 0);
+    }
+}
+
+// Holds on to the tasks it is given until the test runs them
+struct Manual_executor {
+    std::vector< std::packaged_task< void() > > *mTasks;
+
+    template < class Task >
+    std::future< void > operator()(Task &&task) const {
+        return mTasks->emplace_back(std::forward< Task >(task)).get_future();
+    }
+};
+
+void test_clear_parallel_and_deferred() {
+    {
+        T< std::shared_ptr< int > > a {};
+        const auto                  tracked = std::make_shared< int >(0);
+        for (auto i = 0; i < 300000; ++i) { // Enough segments for the destruction to be split between threads
+            a.push(tracked);
+        }
+        for (auto i = 0; i < 1000; ++i) {
+            [[maybe_unused]] const auto popped = a.try_pop();
+            assert(popped);
+        }
+        assert(tracked.use_count() == 299001);
+
+        a.clear_parallel();
+        assert(a.empty() && a.size_hint() == 0 && tracked.use_count() == 1);
+
+        a.push(tracked);
+        [[maybe_unused]] const auto popped  = a.try_pop();
+        [[maybe_unused]] const auto drained = !a.try_pop();
+        assert(popped && *popped == tracked && drained);
+    }
+
+    std::vector< std::packaged_task< void() > > tasks {};
+    {
+        T< Message > a {};
+        for (auto i = 0; i < 1000; ++i) {
+            a.emplace(i, std::string(64, 'x'));
+        }
+        auto destroyed = a.clear_deferred(Manual_executor { &tasks });
+        assert(tasks.size() == 1 && a.empty() && a.size_hint() == 0);
+
+        a.emplace(7, "seven");
+        [[maybe_unused]] const auto popped = a.try_pop();
+        assert(popped && popped->mId == 7 && popped->mBody == "seven");
+
+        tasks.front()();
+        destroyed.get();
+    }
+
+    T< std::string > strings {};
+    for (auto i = 0; i < 100000; ++i) {
+        strings.push(std::string(32, 'y'));
+    }
+    strings.clear_deferred().get();
+    assert(strings.empty());
+}
+
 int main() {
     test_push_try_pop();
     test_push_try_pop2();
     for (auto i = 0; i < 10; ++i) {
         test_push_try_pop_multithread();
     }
+    for (auto i = 0; i < 10; ++i) {
+        test_push_try_pop_concurrent();
+    }
+    test_push_range_try_pop_bulk();
+    test_size_bookkeeping();
+    test_try_pop_moves();
+    test_segment_reuse();
+    test_segment_traits();
+    test_async_pop();
+    test_emplace_and_reserve_slot();
+    test_reserved_slot_blocks_consumers();
+    for (auto i = 0; i < 3; ++i) {
+        test_reserve_slot_concurrent();
+    }
+    test_clear_parallel_and_deferred();
+    for (auto i = 0; i < 10; ++i) {
+        test_async_pop_concurrent();
+    }
+    for (auto i = 0; i < 10; ++i) {
+        test_push_range_try_pop_bulk_concurrent();
+    }
 }
@@ -0,0 +1,260 @@
+#include <concurrent_unordered_map.hpp>
+#include <concurrent_unordered_set.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <future>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Every key lands in one bucket, lookups fall back to the equal-order-key run
+struct Colliding_hash {
+    std::size_t operator()(int) const noexcept { return 42; }
+};
+
+void test_map_basics() {
+    concurrent::concurrent_unordered_map< int, std::string > map {};
+    assert(map.empty() && map.begin() == map.end());
+
+    [[maybe_unused]] const auto [position, inserted] = map.insert({ 1, "one" });
+    assert(inserted && position->first == 1 && position->second == "one");
+    [[maybe_unused]] const auto duplicate = map.insert({ 1, "uno" }).second;
+    assert(!duplicate && map[1] == "one");
+
+    map[2] = "two";
+    map.emplace(3, "three");
+    assert(map.size() == 3 && map.count(2) == 1 && map.contains(3) && !map.contains(4));
+    assert(map.at(3) == "three");
+
+    [[maybe_unused]] auto threw = false;
+    try {
+        (void)map.at(4);
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    assert(threw);
+
+    assert(map.find(4) == map.end() && map.equal_range(4).first == map.end());
+    assert(std::distance(map.equal_range(2).first, map.equal_range(2).second) == 1);
+    assert(std::distance(map.begin(), map.end()) == 3);
+
+    [[maybe_unused]] const auto erased       = map.unsafe_erase(2);
+    [[maybe_unused]] const auto erased_again = map.unsafe_erase(2);
+    assert(erased == 1 && erased_again == 0);
+    assert(map.size() == 2 && !map.contains(2));
+
+    [[maybe_unused]] const auto next = map.unsafe_erase(map.find(1));
+    assert(next == map.end() || next->first == 3);
+    assert(map.size() == 1 && map.begin()->first == 3);
+
+    map.clear();
+    assert(map.empty() && map.begin() == map.end());
+    map[5] = "five";
+    assert(map.size() == 1);
+}
+
+void test_rehash_keeps_elements() {
+    concurrent::concurrent_unordered_map< int, int > map {};
+    [[maybe_unused]] const auto initial_buckets = map.unsafe_bucket_count();
+
+    for (auto i = 0; i < 10000; ++i) {
+        [[maybe_unused]] const auto inserted = map.insert({ i, i * 2 }).second;
+        assert(inserted);
+    }
+    assert(map.size() == 10000);
+    assert(map.unsafe_bucket_count() > initial_buckets);
+    assert(map.load_factor() <= map.max_load_factor() * 2);
+
+    for (auto i = 0; i < 10000; ++i) {
+        assert(map.at(i) == i * 2);
+    }
+
+    map.rehash(1 << 16);
+    assert(map.unsafe_bucket_count() == 1 << 16);
+    for (auto i = 0; i < 10000; i += 7) {
+        assert(map.at(i) == i * 2);
+    }
+
+    std::vector< int > keys {};
+    for (const auto &[key, value] : map) {
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    assert(keys.size() == 10000 && keys.front() == 0 && keys.back() == 9999);
+    assert(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+}
+
+void test_colliding_keys() {
+    concurrent::concurrent_unordered_map< int, int, Colliding_hash > map {};
+    for (auto i = 0; i < 100; ++i) {
+        map[i] = i;
+    }
+    [[maybe_unused]] const auto duplicate = map.insert({ 50, 0 }).second;
+    assert(map.size() == 100 && !duplicate);
+    for (auto i = 0; i < 100; ++i) {
+        assert(map.at(i) == i);
+    }
+    [[maybe_unused]] const auto erased = map.unsafe_erase(50);
+    assert(erased == 1 && !map.contains(50) && map.contains(51));
+}
+
+void test_copy_and_move() {
+    concurrent::concurrent_unordered_map< int, std::string > map { { 1, "a" }, { 2, "b" }, { 3, "c" } };
+
+    auto copy = map;
+    assert(copy.size() == 3 && copy.at(2) == "b");
+    copy[4] = "d";
+    assert(!map.contains(4));
+
+    auto moved = std::move(copy);
+    assert(moved.size() == 4 && copy.empty());
+    copy[7] = "g";
+    assert(copy.size() == 1);
+
+    map = moved;
+    assert(map.size() == 4 && map.at(4) == "d");
+}
+
+void test_concurrent_insert_and_find() {
+    concurrent::concurrent_unordered_map< int, int > map {};
+
+    constexpr auto thread_count = 4;
+    constexpr auto per_thread   = 5000;
+
+    std::atomic< bool >             start { false };
+    std::vector< std::future< void > > writers {};
+    for (auto t = 0; t < thread_count; ++t) {
+        writers.push_back(std::async(std::launch::async, [&map, &start, t] {
+            while (!start) {
+            }
+            for (auto i = 0; i < per_thread; ++i) {
+                const auto                  key      = i * thread_count + t;
+                [[maybe_unused]] const auto inserted = map.insert({ key, key }).second;
+                assert(inserted);
+                assert(map.at(key) == key);
+            }
+        }));
+    }
+
+    // Keys 0..n are racing inserts, each shared key must be inserted exactly once
+    std::atomic< int > duplicate_wins { 0 };
+    auto contended = std::async(std::launch::async, [&map, &start, &duplicate_wins] {
+        while (!start) {
+        }
+        for (auto i = 0; i < 1000; ++i) {
+            if (map.insert({ -1 - i, 0 }).second) {
+                ++duplicate_wins;
+            }
+        }
+    });
+
+    auto reader = std::async(std::launch::async, [&map, &start] {
+        while (!start) {
+        }
+        for (auto round = 0; round < 20; ++round) {
+            for ([[maybe_unused]] const auto &[key, value] : map) {
+                assert(key == value || value == 0);
+            }
+            if (const auto found = map.find(0); found != map.end()) {
+                assert(found->second == 0);
+            }
+        }
+    });
+
+    start = true;
+    for (auto i = 0; i < 1000; ++i) {
+        if (map.insert({ -1 - i, 0 }).second) {
+            ++duplicate_wins;
+        }
+    }
+    for (auto &writer : writers) {
+        writer.get();
+    }
+    contended.get();
+    reader.get();
+
+    assert(duplicate_wins == 1000);
+    assert(map.size() == thread_count * per_thread + 1000);
+    for (auto key = 0; key < thread_count * per_thread; ++key) {
+        assert(map.at(key) == key);
+    }
+}
+
+void test_concurrent_subscript() {
+    concurrent::concurrent_unordered_map< int, std::atomic< int > > map {};
+
+    std::vector< std::future< void > > workers {};
+    for (auto t = 0; t < 4; ++t) {
+        workers.push_back(std::async(std::launch::async, [&map] {
+            for (auto i = 0; i < 1000; ++i) {
+                ++map[i % 64];
+            }
+        }));
+    }
+    for (auto &worker : workers) {
+        worker.get();
+    }
+
+    auto total = 0;
+    for (const auto &[key, value] : map) {
+        total += value;
+    }
+    assert(map.size() == 64 && total == 4000);
+}
+
+void test_set() {
+    using set_type = concurrent::concurrent_unordered_set< std::string >;
+    static_assert(std::is_same_v< set_type::iterator, set_type::const_iterator >);
+    static_assert(std::is_same_v< decltype(*std::declval< set_type & >().begin()), const std::string & >);
+
+    set_type set { "a", "b", "c" };
+    assert(set.size() == 3 && set.contains("b"));
+    [[maybe_unused]] const auto duplicate = set.insert("a").second;
+    [[maybe_unused]] const auto inserted  = set.insert("d").second;
+    assert(!duplicate && inserted);
+    assert(*set.find("d") == "d");
+    [[maybe_unused]] const auto erased = set.unsafe_erase("a");
+    assert(erased == 1 && set.size() == 3);
+
+    std::vector< std::future< void > > workers {};
+    for (auto t = 0; t < 4; ++t) {
+        workers.push_back(std::async(std::launch::async, [&set] {
+            for (auto i = 0; i < 500; ++i) {
+                set.insert(std::to_string(i));
+            }
+        }));
+    }
+    for (auto &worker : workers) {
+        worker.get();
+    }
+    assert(set.size() == 503);
+}
+
+void test_polymorphic_allocator() {
+    std::pmr::monotonic_buffer_resource resource {};
+    using Map = concurrent::concurrent_unordered_map< int, int, std::hash< int >, std::equal_to< int >,
+                                                      std::pmr::polymorphic_allocator< std::pair< const int, int > > >;
+    Map map { &resource };
+    for (auto i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    assert(map.size() == 1000 && map.get_allocator().resource() == &resource);
+}
+
+int main() {
+    test_map_basics();
+    test_rehash_keeps_elements();
+    test_colliding_keys();
+    test_copy_and_move();
+    for (auto i = 0; i < 5; ++i) {
+        test_concurrent_insert_and_find();
+    }
+    test_concurrent_subscript();
+    test_set();
+    test_polymorphic_allocator();
+}
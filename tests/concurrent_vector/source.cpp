@@ -1,6 +1,13 @@
 #include <cassert>
 #include <concurrent_vector.hpp>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <test_common.hpp>
+#include <vector>
 
 void test_iteration() {
     using namespace concurrent;
@@ -23,7 +30,7 @@ void test_shrink_push_grow() {
     v.push_back(21);
     v.push_back(22);
 
-    auto first = v[0];
+    [[maybe_unused]] auto first = v[0];
 
     v.grow_by(5, 23);
 
@@ -33,7 +40,561 @@ void test_shrink_push_grow() {
     CHECK_RESULT(v);
 }
 
+// Shrinking into a vector built in one block keeps the segments of that block, and their ready words with them
+void test_shrink_inside_first_block() {
+    using namespace concurrent;
+
+    concurrent_vector< int > v(std::size_t { 1000 }, 0);
+    v.assign(std::size_t { 10 }, 1);
+    v.shrink_to_fit();
+    for (auto i = 0; i < 100; ++i) {
+        v.push_back(i);
+    }
+    assert(v.size() == 110 && v[9] == 1 && v[10] == 0 && v[109] == 99);
+}
+
+void test_random_access_across_segments() {
+    using namespace concurrent;
+
+    concurrent_vector< int > v {};
+    for (auto i = 0; i < 10000; ++i) {
+        v.push_back(i);
+    }
+
+    for (auto i = 0; i < 10000; i += 7) {
+        assert(v[i] == i);
+        assert(v.at(i) == i);
+    }
+
+    auto expected = 0;
+    for ([[maybe_unused]] auto value : v) {
+        assert(value == expected);
+        ++expected;
+    }
+    assert(expected == 10000);
+
+    const concurrent_vector< int > copy { v };
+    assert(copy.size() == v.size());
+    assert(copy.back() == 9999);
+
+    concurrent_vector< int > filled(std::size_t { 1000 }, 5);
+    filled.grow_by(100, 6);
+    assert(filled[999] == 5 && filled[1000] == 6 && filled[1099] == 6);
+    assert(filled.capacity() >= 1100);
+}
+
+void test_concurrent_push_back_grow_by() {
+    using namespace concurrent;
+
+    constexpr int threads           = 8;
+    constexpr int pushes_per_thread = 20000;
+    constexpr int grows_per_thread  = 100;
+    constexpr int grow_size         = 10;
+
+    concurrent_vector< int > v {};
+
+    std::vector< std::future< void > > fn {};
+    for (auto t = 0; t < threads; ++t) {
+        fn.emplace_back(std::async(std::launch::async, [&v, t]() {
+            for (auto i = 0; i < pushes_per_thread; ++i) {
+                [[maybe_unused]] auto &element = v.emplace_back(t * pushes_per_thread + i);
+                assert(element == t * pushes_per_thread + i);
+                if (i % (pushes_per_thread / grows_per_thread) == 0) {
+                    v.grow_by(grow_size, -1);
+                }
+            }
+        }));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+
+    constexpr int pushed = threads * pushes_per_thread;
+    assert(v.size() == pushed + threads * grows_per_thread * grow_size);
+
+    std::vector< int > seen(pushed, 0);
+    auto               filler = 0;
+    for (auto value : v) {
+        if (value == -1) {
+            ++filler;
+        } else {
+            ++seen[value];
+        }
+    }
+    assert(filler == threads * grows_per_thread * grow_size);
+    for ([[maybe_unused]] auto count : seen) {
+        assert(count == 1);
+    }
+}
+
+template < class Range >
+void visit_range(Range range, std::vector< int > &seen) {
+    while (range.is_divisible()) {
+        visit_range(range.split(), seen);
+    }
+    for (auto span : range.segments()) {
+        for (auto value : span) {
+            ++seen[value];
+        }
+    }
+}
+
+void test_segments_and_range() {
+    using namespace concurrent;
+
+    concurrent_vector< int > v {};
+    for (auto i = 0; i < 5000; ++i) {
+        v.push_back(i);
+    }
+
+    std::size_t total  = 0;
+    std::size_t blocks = 0;
+    for (auto span : v.segments()) {
+        assert(span.front() == static_cast< int >(total)); // Blocks are contiguous and in index order
+        for (std::size_t i = 1; i < span.size(); ++i) {
+            assert(&span[i] == &span[0] + i && span[i] == span[0] + static_cast< int >(i));
+        }
+        total += span.size();
+        ++blocks;
+    }
+    assert(total == v.size());
+    assert(blocks > 1 && blocks < 16);
+
+    for (auto span : v.segments()) {
+        for (auto &value : span) {
+            value *= 2;
+        }
+    }
+    assert(v[4999] == 9998);
+
+    const auto &cv = v;
+    std::vector< int > seen(10000, 0);
+    visit_range(cv.range(64), seen);
+    for (auto i = 0; i < 10000; ++i) {
+        assert(seen[i] == (i % 2 == 0 ? 1 : 0));
+    }
+
+    auto range = v.range();
+    [[maybe_unused]] auto upper = range.split();
+    assert(range.size() + upper.size() == v.size() && !range.empty() && !upper.empty());
+    assert(*upper.begin() == v[range.size()]);
+
+    concurrent_vector< int > empty {};
+    assert(empty.segments().begin() == empty.segments().end());
+    assert(empty.range().empty() && !empty.range().is_divisible());
+}
+
+void test_iterator_across_segments() {
+    using namespace concurrent;
+
+    concurrent_vector< int > v {};
+    for (auto i = 0; i < 3000; ++i) {
+        v.push_back(i);
+    }
+
+    auto it = v.begin();
+    for (auto i = 0; i < 3000; ++i, ++it) {
+        assert(*it == i);
+    }
+    assert(it == v.end());
+
+    for (auto i = 2999; i >= 0; --i) {
+        assert(*--it == i);
+    }
+
+    auto old = it++; // Postfix returns the previous position by value
+    assert(*old == 0 && *it == 1);
+    old = it--;
+    assert(*old == 1 && *it == 0);
+
+    it += 1500;
+    assert(*it == 1500 && it[-1000] == 500 && it[1499] == 2999);
+    assert(*it == 1500); // Subscripting elsewhere leaves the iterator's own element alone
+    it -= 1499;
+    assert(*it == 1 && *(it + 2998) == 2999 && (v.end() - it) == 2999);
+
+    const auto &cv  = v;
+    auto        sum = 0LL;
+    for (auto cit = cv.cbegin(); cit != cv.cend(); ++cit) {
+        sum += *cit;
+    }
+    assert(sum == 2999LL * 3000 / 2);
+}
+
+void test_lock_free_readers() {
+    using namespace concurrent;
+
+    constexpr int elements = 100000;
+    constexpr int readers  = 4;
+
+    concurrent_vector< int > v {};
+    std::atomic< bool >      done { false };
+
+    std::vector< std::future< void > > fn {};
+    for (auto r = 0; r < readers; ++r) {
+        fn.emplace_back(std::async(std::launch::async, [&v, &done]() {
+            while (!done.load()) {
+                const auto size = v.size();
+                if (size == 0) {
+                    continue;
+                }
+                try {
+                    assert(v.at(size - 1) == static_cast< int >(size - 1)); // Published means fully constructed
+                } catch (const std::out_of_range &) {
+                    // Handed out but still being constructed
+                }
+                assert(!v.empty());
+
+                // A range stops short of the appends still in flight, so every element it covers can be read
+                std::size_t visited = 0;
+                for (const auto block : v.segments()) {
+                    for ([[maybe_unused]] const auto value : block) {
+                        assert(value == static_cast< int >(visited));
+                        ++visited;
+                    }
+                }
+                assert(visited <= v.size());
+            }
+        }));
+    }
+    for (auto i = 0; i < elements; ++i) {
+        v.push_back(i);
+    }
+    done.store(true);
+    for (auto &f : fn) {
+        f.wait();
+    }
+    assert(v.at(elements - 1) == elements - 1);
+}
+
+struct Throwing_element {
+    static inline std::atomic< int > live { 0 }; // Destroyed on several threads by clear_parallel
+    int                              mValue;
+
+    Throwing_element(int value) : mValue(value) { ++live; }
+    Throwing_element(const Throwing_element &rhs) : mValue(rhs.mValue) {
+        if (mValue < 0) {
+            throw std::runtime_error("copy failed");
+        }
+        ++live;
+    }
+    ~Throwing_element() { --live; }
+};
+
+void test_failed_append_leaves_hole() {
+    using namespace concurrent;
+
+    {
+        concurrent_vector< Throwing_element > v {};
+        v.push_back(Throwing_element { 1 });
+        try {
+            v.grow_by(3, Throwing_element { -1 });
+            assert(false);
+        } catch (const std::runtime_error &) {
+        }
+        v.push_back(Throwing_element { 2 });
+
+        assert(v.size() == 5 && Throwing_element::live == 2);
+        assert(v.at(0).mValue == 1 && v.at(4).mValue == 2);
+        try {
+            (void)v.at(2);
+            assert(false);
+        } catch (const std::out_of_range &) {
+        }
+    }
+    assert(Throwing_element::live == 0); // The destructor skipped the slots that never held an element
+}
+
+void test_pop_back() {
+    using namespace concurrent;
+
+    {
+        concurrent_vector< Throwing_element > v {};
+        v.push_back(Throwing_element { 1 });
+        v.push_back(Throwing_element { 2 });
+        try {
+            v.push_back(Throwing_element { -1 });
+            assert(false);
+        } catch (const std::runtime_error &) {
+        }
+        assert(v.size() == 3 && Throwing_element::live == 2);
+
+        v.pop_back(); // The hole left by the failed append
+        assert(v.size() == 2 && Throwing_element::live == 2);
+
+        v.pop_back();
+        assert(v.size() == 1 && Throwing_element::live == 1 && v.back().mValue == 1);
+
+        v.push_back(Throwing_element { 3 });
+        assert(v.at(1).mValue == 3 && Throwing_element::live == 2);
+    }
+    assert(Throwing_element::live == 0);
+}
+
+void test_grow_to_at_least() {
+    using namespace concurrent;
+
+    concurrent_vector< int > v {};
+    [[maybe_unused]] auto first = v.grow_by(3, 7);
+    assert(first == v.begin() && v.size() == 3);
+    [[maybe_unused]] const auto none = v.grow_by(0);
+    assert(none == v.end());
+
+    auto grown = v.grow_to_at_least(10, 9);
+    assert(grown - v.begin() == 3 && v.size() == 10 && v[2] == 7 && v[3] == 9 && v[9] == 9);
+    grown = v.grow_to_at_least(5);
+    assert(grown - v.begin() == 5 && v.size() == 10);
+
+    std::vector< std::future< void > > fn {};
+    for (auto t = 1; t <= 8; ++t) {
+        fn.emplace_back(std::async(std::launch::async, [&v, t]() { v.grow_to_at_least(t * 1000, t); }));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+    assert(v.size() == 8000);
+    for (std::size_t i = 10; i < v.size(); ++i) {
+        assert(v.at(i) >= 1 && v.at(i) <= 8);
+    }
+
+    // Large fills take the bulk paths, zero bytes are memset and other patterns copied in bulk
+    concurrent_vector< long long > zeros {};
+    zeros.grow_by(1 << 20);
+    concurrent_vector< long long > pattern {};
+    pattern.grow_to_at_least(1 << 20, 0x0102030405060708LL);
+    for (auto i = 0; i < (1 << 20); i += 4093) {
+        assert(zeros.at(i) == 0 && pattern.at(i) == 0x0102030405060708LL);
+    }
+
+    concurrent_vector< std::string > strings(std::size_t { 50000 }, std::string(40, 'x'));
+    strings.grow_to_at_least(100000, std::string(40, 'y'));
+    assert(strings.at(49999) == std::string(40, 'x') && strings.at(99999) == std::string(40, 'y'));
+}
+
+void test_bitwise_copies() {
+    using namespace concurrent;
+
+    std::vector< int > source(5000);
+    for (auto i = 0; i < 5000; ++i) {
+        source[i] = i;
+    }
+
+    concurrent_vector< int > v(source.begin(), source.end()); // Contiguous source, copied segment by segment
+    assert(v.size() == 5000 && v.at(0) == 0 && v.at(4999) == 4999);
+
+    const concurrent_vector< int > copy { v }; // Segments of both vectors line up
+    concurrent_vector< int >       shifted(v.begin() + 5, v.end()); // They do not
+    concurrent_vector< int >       moved { std::move(v) };
+    for (auto i = 0; i < 5000; ++i) {
+        assert(copy[i] == i && moved[i] == i);
+    }
+    for (auto i = 0; i < 4995; ++i) {
+        assert(shifted[i] == i + 5);
+    }
+
+    moved.assign(source.begin(), source.begin() + 3000); // Reused slots are assigned in bulk
+    assert(moved.size() == 3000 && moved.at(2999) == 2999);
+    moved.assign(source.rbegin(), source.rend());
+    assert(moved.size() == 5000 && moved.at(0) == 4999 && moved.at(4999) == 0);
+}
+
+void test_compact() {
+    using namespace concurrent;
+
+    concurrent_vector< std::string > v {};
+    for (auto i = 0; i < 5000; ++i) {
+        v.push_back(std::to_string(i));
+    }
+    v.compact();
+    assert(v.size() == 5000 && v.capacity() >= 5000);
+
+    auto blocks = 0;
+    for (auto span : v.segments()) {
+        assert(span.size() == 5000 && span[4999] == "4999");
+        ++blocks;
+    }
+    assert(blocks == 1);
+
+    v.push_back("5000"); // Grows past the compacted block again
+    assert(v.at(5000) == "5000" && v.at(0) == "0");
+
+    concurrent_vector< int > ints {};
+    for (auto i = 0; i < 3000; ++i) {
+        ints.push_back(i);
+    }
+    ints.reserve(100000);
+    ints.compact(); // Also frees the segments past the last element
+    assert(ints.capacity() < 100000 && (*ints.segments().begin()).size() == 3000 && ints[2999] == 2999);
+
+    // Nothing to merge inside the first block, compact only frees the tail and appends must still find their words
+    concurrent_vector< int > shrunk(std::size_t { 1000 }, 0);
+    shrunk.assign(std::size_t { 10 }, 1);
+    shrunk.compact();
+    for (auto i = 0; i < 2000; ++i) {
+        shrunk.push_back(i);
+    }
+    assert(shrunk.size() == 2010 && shrunk[9] == 1 && shrunk[10] == 0 && shrunk[2009] == 1999);
+
+    {
+        concurrent_vector< Throwing_element > holes {};
+        holes.push_back(Throwing_element { 1 });
+        for (auto i = 0; i < 100; ++i) {
+            holes.push_back(Throwing_element { i });
+        }
+        try {
+            holes.grow_by(3, Throwing_element { -1 });
+            assert(false);
+        } catch (const std::runtime_error &) {
+        }
+        holes.push_back(Throwing_element { 2 });
+        holes.compact(); // The holes stay holes
+        assert(holes.size() == 105 && Throwing_element::live == 102);
+        assert(holes.at(100).mValue == 99 && holes.at(104).mValue == 2);
+        try {
+            (void)holes.at(102);
+            assert(false);
+        } catch (const std::out_of_range &) {
+        }
+    }
+    assert(Throwing_element::live == 0);
+
+    {
+        concurrent_vector< Throwing_element > failing {};
+        for (auto i = 0; i < 100; ++i) {
+            failing.push_back(Throwing_element { i });
+        }
+        failing[50].mValue = -1; // Its copy into the new block throws
+        try {
+            failing.compact();
+            assert(false);
+        } catch (const std::runtime_error &) {
+        }
+        assert(Throwing_element::live == 100 && failing.at(49).mValue == 49 && failing.at(99).mValue == 99);
+        assert((*failing.segments().begin()).size() < 100); // Still the old segments
+        failing[50].mValue = 50;
+    }
+    assert(Throwing_element::live == 0);
+}
+
+void test_snapshot() {
+    using namespace concurrent;
+
+    concurrent_vector< int > v {};
+    for (auto i = 0; i < 200000; ++i) { // Large enough for the copy to be split between threads
+        v.push_back(i);
+    }
+    const auto copy = v.snapshot();
+    assert(copy.size() == 200000);
+    for (auto i = 0; i < 200000; ++i) {
+        assert(copy[i] == i);
+    }
+
+    std::vector< int > buffer(100, -1);
+    [[maybe_unused]] const auto copied = v.snapshot(std::span< int > { buffer });
+    assert(copied == 100 && buffer[99] == 99);
+
+    concurrent_vector< Throwing_element > holes {};
+    holes.push_back(Throwing_element { 1 });
+    try {
+        holes.push_back(Throwing_element { -1 });
+        assert(false);
+    } catch (const std::runtime_error &) {
+    }
+    holes.push_back(Throwing_element { 2 });
+    const auto prefix = holes.snapshot(); // Not default constructible, and stops at the hole
+    assert(prefix.size() == 1 && prefix[0].mValue == 1);
+
+    // Snapshots taken while appends continue are a prefix of the final contents
+    concurrent_vector< int > growing {};
+    auto appender = std::async(std::launch::async, [&growing] {
+        for (auto i = 0; i < 100000; ++i) {
+            growing.push_back(i);
+        }
+    });
+    [[maybe_unused]] std::size_t last_size = 0;
+    for (auto round = 0; round < 50; ++round) {
+        const auto partial = growing.snapshot();
+        assert(partial.size() >= last_size);
+        for (std::size_t i = 0; i < partial.size(); ++i) {
+            assert(partial[i] == static_cast< int >(i));
+        }
+        last_size = partial.size();
+    }
+    appender.wait();
+    assert(growing.snapshot().size() == 100000);
+}
+
+// Holds on to the tasks it is given until the test runs them
+struct Manual_executor {
+    std::vector< std::packaged_task< void() > > *mTasks;
+
+    template < class Task >
+    std::future< void > operator()(Task &&task) const {
+        return mTasks->emplace_back(std::forward< Task >(task)).get_future();
+    }
+};
+
+void test_clear_parallel_and_deferred() {
+    using namespace concurrent;
+
+    {
+        concurrent_vector< Throwing_element > v {};
+        for (auto i = 0; i < 300000; ++i) { // Large enough for the destruction to be split between threads
+            v.push_back(Throwing_element { i });
+        }
+        try {
+            v.push_back(Throwing_element { -1 });
+            assert(false);
+        } catch (const std::runtime_error &) {
+        }
+        v.push_back(Throwing_element { 7 });
+
+        [[maybe_unused]] const auto capacity = v.capacity();
+        v.clear_parallel();
+        assert(v.empty() && Throwing_element::live == 0 && v.capacity() == capacity);
+        v.push_back(Throwing_element { 1 });
+        assert(v.size() == 1 && v[0].mValue == 1);
+    }
+    assert(Throwing_element::live == 0);
+
+    std::vector< std::packaged_task< void() > > tasks {};
+    {
+        concurrent_vector< Throwing_element > v {};
+        for (auto i = 0; i < 1000; ++i) {
+            v.push_back(Throwing_element { i });
+        }
+        auto destroyed = v.clear_deferred(Manual_executor { &tasks });
+        assert(tasks.size() == 1 && Throwing_element::live == 1000); // Nothing destroyed on this thread
+        assert(v.empty() && v.capacity() == 0);
+
+        v.push_back(Throwing_element { 5 });
+        assert(v.size() == 1 && v[0].mValue == 5);
+
+        tasks.front()();
+        destroyed.get();
+        assert(Throwing_element::live == 1);
+    }
+    assert(Throwing_element::live == 0);
+
+    concurrent_vector< std::string > strings(100000, std::string(32, 'x'));
+    strings.clear_deferred().get();
+    assert(strings.empty());
+}
+
 int main() {
     test_iteration();
     test_shrink_push_grow();
+    test_shrink_inside_first_block();
+    test_random_access_across_segments();
+    test_concurrent_push_back_grow_by();
+    test_segments_and_range();
+    test_iterator_across_segments();
+    test_lock_free_readers();
+    test_failed_append_leaves_hole();
+    test_pop_back();
+    test_grow_to_at_least();
+    test_bitwise_copies();
+    test_compact();
+    test_snapshot();
+    test_clear_parallel_and_deferred();
 }
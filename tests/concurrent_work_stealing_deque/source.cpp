@@ -0,0 +1,138 @@
+#include <concurrent_work_stealing_deque.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+template < class Type >
+using T = concurrent::concurrent_work_stealing_deque< Type >;
+
+// Upstream that counts the blocks still outstanding
+struct Counting_resource : std::pmr::memory_resource {
+    std::atomic< std::size_t > allocations   = 0;
+    std::atomic< std::size_t > deallocations = 0;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+void test_owner_lifo_thief_fifo() {
+    T< int >                    a {};
+    int                         v;
+    [[maybe_unused]] const auto popped_empty = a.try_pop(v);
+    [[maybe_unused]] const auto stole_empty  = a.try_steal(v);
+    assert(a.empty() && !popped_empty && !stole_empty);
+
+    // Grows several times
+    for (auto i = 0; i < 1000; ++i) {
+        a.push(i);
+    }
+    assert(a.size_hint() == 1000);
+
+    [[maybe_unused]] const auto newest = a.try_pop(v);
+    assert(newest && v == 999);
+    [[maybe_unused]] const auto oldest = a.try_steal(v);
+    assert(oldest && v == 0);
+    [[maybe_unused]] const auto second_oldest = a.try_steal(v);
+    assert(second_oldest && v == 1);
+    [[maybe_unused]] const auto second_newest = a.try_pop(v);
+    assert(second_newest && v == 998);
+
+    for (auto expected = 997; expected >= 2; --expected) {
+        [[maybe_unused]] const auto popped = a.try_pop(v);
+        assert(popped && v == expected);
+    }
+    [[maybe_unused]] const auto popped_drained = a.try_pop(v);
+    [[maybe_unused]] const auto stole_drained  = a.try_steal(v);
+    assert(a.empty() && !popped_drained && !stole_drained);
+
+    // Wrap around the circular buffer without growing
+    for (auto round = 0; round < 100; ++round) {
+        a.push(round);
+        a.push(round + 1);
+        [[maybe_unused]] const auto stolen = a.try_steal(v);
+        assert(stolen && v == round);
+        [[maybe_unused]] const auto popped = a.try_pop(v);
+        assert(popped && v == round + 1);
+    }
+}
+
+void test_steal_concurrent() {
+    constexpr int thieves = 4;
+    constexpr int count   = 200000;
+
+    T< int >                       a {};
+    std::atomic_bool               done = false;
+    std::vector< std::atomic_int > taken(count);
+
+    auto steal = [&]() {
+        int v;
+        while (!done || !a.empty()) {
+            if (a.try_steal(v)) {
+                ++taken[v];
+            }
+        }
+    };
+
+    std::vector< std::future< void > > fn {};
+    for (auto i = 0; i < thieves; ++i) {
+        fn.emplace_back(std::async(std::launch::async, steal));
+    }
+
+    // The owner mixes pushes with pops of its own
+    int v;
+    for (auto i = 0; i < count; ++i) {
+        a.push(i);
+        if (i % 3 == 0 && a.try_pop(v)) {
+            ++taken[v];
+        }
+    }
+    while (a.try_pop(v)) {
+        ++taken[v];
+    }
+    done = true;
+
+    for (auto &f : fn) {
+        f.wait();
+    }
+    for ([[maybe_unused]] const auto &count_taken : taken) {
+        assert(count_taken == 1);
+    }
+}
+
+void test_outgrown_buffers_are_freed() {
+    Counting_resource upstream {};
+    {
+        concurrent::concurrent_work_stealing_deque< int, std::pmr::polymorphic_allocator< int > > a { &upstream };
+        for (auto i = 0; i < 100000; ++i) {
+            a.push(i);
+        }
+        // No thief is running, so every outgrown buffer went right away and only the live one is left
+        assert(upstream.allocations > 2 && upstream.allocations - upstream.deallocations == 2);
+
+        int v;
+        while (a.try_steal(v)) {
+        }
+        assert(a.empty());
+    }
+    assert(upstream.allocations == upstream.deallocations);
+}
+
+int main() {
+    test_owner_lifo_thief_fifo();
+    test_outgrown_buffers_are_freed();
+    for (auto i = 0; i < 10; ++i) {
+        test_steal_concurrent();
+    }
+}
@@ -0,0 +1,119 @@
+#include <cassert>
+#include <concurrent_queue.hpp>
+#include <concurrent_vector.hpp>
+#include <future>
+#include <vector>
+
+void test_queue_stats() {
+    static_assert(concurrent::container_stats::enabled);
+
+    concurrent::concurrent_queue< int > queue {};
+    assert(queue.stats().pushes == 0 && queue.stats().bytes_held() == 0);
+
+    constexpr int threads = 4;
+    constexpr int pushes  = 10000;
+
+    std::vector< std::future< void > > fn {};
+    for (auto t = 0; t < threads; ++t) {
+        fn.emplace_back(std::async(std::launch::async, [&queue]() {
+            for (auto i = 0; i < pushes; ++i) {
+                queue.push(i);
+            }
+        }));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+
+    std::vector< int > batch(100, 1);
+    queue.push_range(batch.begin(), batch.end());
+
+    int value;
+    for (auto i = 0; i < 1000; ++i) {
+        [[maybe_unused]] const auto popped = queue.try_pop(value);
+        assert(popped);
+    }
+    [[maybe_unused]] const auto discarded = queue.try_pop();
+    assert(discarded);
+    std::vector< int > drained {};
+    while (queue.try_pop_bulk(std::back_inserter(drained), 256) != 0) {
+    }
+    [[maybe_unused]] const auto empty = !queue.try_pop(value);
+    assert(empty);
+
+    [[maybe_unused]] const auto stats = queue.stats();
+    assert(stats.pushes == threads * pushes + 100);
+    assert(stats.pops == stats.pushes && stats.backlog() == 0);
+    assert(stats.failed_pops == 2); // The final empty try_pop_bulk and try_pop
+    assert(stats.segment_allocations > 0 && stats.bytes_held() > 0);
+    assert(stats.bytes_allocated >= stats.bytes_held());
+}
+
+void test_clear_deferred_hands_over_bytes() {
+    concurrent::concurrent_queue< int > queue {};
+    for (auto i = 0; i < 10000; ++i) {
+        queue.push(i);
+    }
+    assert(queue.stats().bytes_held() > 0);
+
+    // The detached segments are no longer held by the queue, whether or not the task freed them already
+    auto destroyed = queue.clear_deferred();
+    assert(queue.stats().bytes_held() == 0);
+    destroyed.get();
+
+    queue.push(1);
+    [[maybe_unused]] const auto stats = queue.stats();
+    assert(stats.bytes_held() > 0 && stats.bytes_allocated > stats.bytes_released);
+}
+
+void test_vector_stats() {
+    concurrent::concurrent_vector< long > vector {};
+    for (auto i = 0; i < 1000; ++i) {
+        vector.push_back(i);
+    }
+    vector.grow_by(24);
+    vector.grow_to_at_least(2000);
+
+    auto stats = vector.stats();
+    assert(stats.pushes == 2000 && stats.pops == 0);
+    assert(stats.segment_allocations > 0 && stats.bytes_held() >= vector.size() * sizeof(long));
+
+    vector.clear();
+    vector.shrink_to_fit();
+    stats = vector.stats();
+    assert(stats.bytes_held() == 0 && stats.bytes_released == stats.bytes_allocated);
+}
+
+void test_vector_clear_deferred_hands_over_bytes() {
+    concurrent::concurrent_vector< long > vector(5000, 1L);
+    assert(vector.stats().bytes_held() >= 5000 * sizeof(long));
+
+    auto destroyed = vector.clear_deferred();
+    assert(vector.stats().bytes_held() == 0);
+    destroyed.get();
+
+    vector.push_back(1);
+    [[maybe_unused]] const auto stats = vector.stats();
+    assert(stats.bytes_held() > 0 && stats.bytes_allocated > stats.bytes_released);
+}
+
+void test_vector_swap_hands_over_bytes() {
+    concurrent::concurrent_vector< long > full {};
+    concurrent::concurrent_vector< long > empty {};
+    for (auto i = 0; i < 5000; ++i) {
+        full.push_back(i);
+    }
+    full.swap(empty);
+
+    // The bytes follow the segments, the event counts stay where they were recorded
+    assert(full.stats().bytes_held() == 0 && full.stats().pushes == 5000);
+    assert(empty.stats().bytes_held() >= 5000 * sizeof(long) && empty.stats().pushes == 0);
+}
+
+int main() {
+    test_queue_stats();
+    test_clear_deferred_hands_over_bytes();
+    test_vector_stats();
+    test_vector_clear_deferred_hands_over_bytes();
+    test_vector_swap_hands_over_bytes();
+}
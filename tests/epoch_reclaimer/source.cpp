@@ -0,0 +1,156 @@
+#include <epoch_reclaimer.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct Node {
+    std::atomic< int >         mValue { 0 };
+    Node *                     mRetiredNext { nullptr };
+    concurrent::impl::epoch_type mRetireEpoch { 0 };
+};
+
+struct Counting_reclaim {
+    std::atomic< int > *mReclaimed;
+
+    void operator()(Node *node) const noexcept {
+        node->mValue = -1; // Poison, a reader still holding the node would notice
+        delete node;
+        ++*mReclaimed;
+    }
+};
+
+template < std::size_t BatchSize >
+using Reclaimer = concurrent::impl::Epoch_reclaimer< Node, Counting_reclaim, BatchSize >;
+
+void test_batches_single_thread() {
+    std::atomic< int > reclaimed { 0 };
+    Reclaimer< 4 >     reclaimer { Counting_reclaim { &reclaimed } };
+
+    for (auto i = 0; i < 3; ++i) {
+        typename Reclaimer< 4 >::Guard guard { reclaimer };
+        reclaimer.Retire(new Node {});
+    }
+    assert(reclaimed == 0); // Below the batch size
+
+    {
+        typename Reclaimer< 4 >::Guard guard { reclaimer };
+        reclaimer.Retire(new Node {});
+        {
+            typename Reclaimer< 4 >::Guard nested { reclaimer };
+        }
+        assert(reclaimed == 0); // Still inside the outermost guard
+    }
+    assert(reclaimed == 4); // Nobody else is active, the whole batch goes at once
+
+    {
+        typename Reclaimer< 4 >::Guard guard { reclaimer };
+        reclaimer.Retire(new Node {});
+    }
+    reclaimer.Drain();
+    assert(reclaimed == 5);
+}
+
+void test_stalled_reader_holds_back_newer_nodes() {
+    std::atomic< int > reclaimed { 0 };
+    Reclaimer< 1 >     reclaimer { Counting_reclaim { &reclaimed } };
+
+    std::atomic< int > phase { 0 };
+    auto               reader = std::async(std::launch::async, [&reclaimer, &phase] {
+        {
+            typename Reclaimer< 1 >::Guard guard { reclaimer };
+            phase = 1;
+            while (phase != 2) {
+                std::this_thread::yield();
+            }
+        }
+        // Busy again right away, the old scheme of counting operations in flight would never drain here
+        typename Reclaimer< 1 >::Guard guard { reclaimer };
+        phase = 3;
+        while (phase != 4) {
+            std::this_thread::yield();
+        }
+    });
+
+    // Every retire runs in an operation of its own, the guard collects on the way out
+    const auto retire = [&reclaimer] {
+        typename Reclaimer< 1 >::Guard guard { reclaimer };
+        reclaimer.Retire(new Node {});
+    };
+
+    while (phase != 1) {
+        std::this_thread::yield();
+    }
+    retire();
+    retire();
+    assert(reclaimed == 0); // The reader may still see them
+
+    phase = 2;
+    while (phase != 3) {
+        std::this_thread::yield();
+    }
+    // The reader re-entered in a later epoch, the first node was retired before that and is unreachable for it
+    auto retired = 2;
+    for (; retired < 6 && reclaimed == 0; ++retired) {
+        retire();
+    }
+    assert(reclaimed >= 1);
+
+    phase = 4;
+    reader.get();
+
+    // An idle thread holds nothing back
+    retire();
+    assert(reclaimed == retired + 1);
+}
+
+void test_readers_never_see_reclaimed_nodes() {
+    std::atomic< int > reclaimed { 0 };
+    auto               reclaimer = std::make_unique< Reclaimer< 8 > >(Counting_reclaim { &reclaimed });
+
+    std::atomic< Node * > current { new Node {} };
+    std::atomic< bool >   done { false };
+
+    std::vector< std::future< void > > readers {};
+    for (auto t = 0; t < 3; ++t) {
+        readers.push_back(std::async(std::launch::async, [&reclaimer, &current, &done] {
+            while (!done) {
+                typename Reclaimer< 8 >::Guard guard { *reclaimer };
+                [[maybe_unused]] const auto    node = current.load();
+                for (auto i = 0; i < 16; ++i) {
+                    assert(node->mValue.load() >= 0);
+                }
+            }
+        }));
+    }
+
+    constexpr auto replacements = 20000;
+    for (auto i = 1; i <= replacements; ++i) {
+        typename Reclaimer< 8 >::Guard guard { *reclaimer };
+        auto                           replacement = new Node {};
+        replacement->mValue                        = i;
+        reclaimer->Retire(current.exchange(replacement));
+    }
+    done = true;
+    for (auto &reader : readers) {
+        reader.get();
+    }
+
+    assert(reclaimed > 0);
+    reclaimer->Drain();
+    assert(reclaimed == replacements);
+    delete current.load();
+}
+
+int main() {
+    test_batches_single_thread();
+    for (auto i = 0; i < 10; ++i) {
+        test_stalled_reader_holds_back_newer_nodes();
+    }
+    for (auto i = 0; i < 3; ++i) {
+        test_readers_never_see_reclaimed_nodes();
+    }
+}
@@ -0,0 +1,295 @@
+// Stress harness for the queues: runs producer/consumer topologies with every thread busy at once and reports the
+// enqueue-to-dequeue latency distribution and the sustained throughput of each run.
+//
+//   QueueLatency [--queue=concurrent|sharded|bounded|spsc|all] [--topology=spsc|mpsc|mpmc|all]
+//                [--producers=N] [--consumers=N] [--items=N] [--rate=N] [--capacity=N] [--pin=0|1]
+//
+// --items counts the items of each producer, --rate paces each producer to that many items per second (0, the
+// default, pushes as fast as possible and so measures the queue saturated), --capacity bounds the bounded queue.
+// Latency is taken from the time an item was due to be pushed, so a producer that fell behind its rate does not hide
+// the delay from the distribution. Without arguments every queue
+// runs every topology it supports with a short item count, so the harness doubles as a smoke test: it fails when an
+// item is lost, duplicated or overtakes an earlier item of its producer.
+#include <concurrent_bounded_queue.hpp>
+#include <concurrent_queue.hpp>
+#include <sharded_concurrent_queue.hpp>
+#include <spsc_queue.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif // __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    struct Item {
+        std::uint32_t mProducer { 0 };
+        std::uint32_t mSequence { 0 };
+        std::int64_t  mEnqueued { 0 }; // Nanoseconds on clock_type
+    };
+
+    struct Config {
+        std::string   mQueue { "all" };
+        std::string   mTopology { "all" };
+        unsigned      mProducers { 4 };
+        unsigned      mConsumers { 4 };
+        std::uint32_t mItems { 20000 };
+        double        mRate { 0 };
+        std::size_t   mCapacity { 1024 };
+        bool          mPin { true };
+    };
+
+    struct Topology {
+        const char *mName;
+        unsigned    mProducers;
+        unsigned    mConsumers;
+    };
+
+    std::int64_t Now() noexcept {
+        return std::chrono::duration_cast< std::chrono::nanoseconds >(clock_type::now().time_since_epoch()).count();
+    }
+
+    // Spreads the threads of a run over the CPUs in order, a no-op where affinity can not be set
+    void Pin_to_cpu(const unsigned thread_index) noexcept {
+#ifdef __linux__
+        const auto cpus = std::max(std::thread::hardware_concurrency(), 1U);
+        cpu_set_t  set;
+        CPU_ZERO(&set);
+        CPU_SET(thread_index % cpus, &set);
+        (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)thread_index;
+#endif // __linux__
+    }
+
+    template < class Queue >
+    std::unique_ptr< Queue > Make_queue(const Config &config) {
+        if constexpr (std::is_constructible_v< Queue, std::size_t >) {
+            return std::make_unique< Queue >(config.mCapacity);
+        } else {
+            (void)config;
+            return std::make_unique< Queue >();
+        }
+    }
+
+    // Value at fraction of the sorted samples, nearest rank
+    double Percentile_us(const std::vector< std::int64_t > &sorted, const double fraction) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        const auto rank = static_cast< std::size_t >(fraction * static_cast< double >(sorted.size() - 1) + 0.5);
+        return static_cast< double >(sorted[rank]) / 1000.0;
+    }
+
+    /// <summary>
+    /// Starts every producer and consumer behind one barrier, so the run measures them overlapping. Producers stamp
+    /// each item as they push it, consumers record the age of each item they pop and check that the items of every
+    /// producer arrive in order. Returns false if the items popped are not exactly the ones pushed.
+    /// </summary>
+    template < class Queue >
+    bool Run(const char *queue_name, const Topology &topology, const Config &config) {
+        const auto queue     = Make_queue< Queue >(config);
+        const auto producers = topology.mProducers;
+        const auto consumers = topology.mConsumers;
+        const auto total     = static_cast< std::uint64_t >(producers) * config.mItems;
+
+        std::atomic< unsigned >      waiting { producers + consumers };
+        std::atomic< std::int64_t >  start { 0 };
+        std::atomic< std::uint64_t > popped { 0 };
+        std::atomic< bool >          ordered { true };
+
+        std::vector< std::vector< std::int64_t > > latencies(consumers);
+        std::vector< std::uint64_t >               sequence_sums(consumers, 0);
+        std::vector< std::int64_t >                last_pop(consumers, 0);
+        std::vector< std::thread >                 threads {};
+
+        // The last thread to arrive starts the clock and releases the others
+        const auto start_together = [&waiting, &start](const unsigned thread_index, const bool pin) {
+            if (pin) {
+                Pin_to_cpu(thread_index);
+            }
+            if (waiting.fetch_sub(1) == 1) {
+                start.store(Now());
+            }
+            while (start.load() == 0) {
+                std::this_thread::yield();
+            }
+            return start.load();
+        };
+
+        const auto interval = config.mRate > 0 ? static_cast< std::int64_t >(1e9 / config.mRate) : 0;
+        for (unsigned producer = 0; producer < producers; ++producer) {
+            threads.emplace_back([&, producer] {
+                const auto begin = start_together(producer, config.mPin);
+                for (std::uint32_t sequence = 0; sequence < config.mItems; ++sequence) {
+                    auto due = Now();
+                    if (interval != 0) {
+                        due = begin + static_cast< std::int64_t >(sequence) * interval;
+                        while (Now() < due) {
+                            std::this_thread::yield();
+                        }
+                    }
+                    queue->push(Item { producer, sequence, due });
+                }
+            });
+        }
+        for (unsigned consumer = 0; consumer < consumers; ++consumer) {
+            threads.emplace_back([&, consumer] {
+                start_together(producers + consumer, config.mPin);
+
+                auto &samples = latencies[consumer];
+                samples.reserve(total / consumers + 1);
+                std::vector< std::uint64_t > next_sequence(producers, 0);
+
+                Item item {};
+                while (popped.load(std::memory_order_relaxed) < total) {
+                    if (!queue->try_pop(item)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    const auto now = Now();
+                    samples.push_back(now - item.mEnqueued);
+                    last_pop[consumer] = now;
+                    sequence_sums[consumer] += item.mSequence;
+                    if (item.mProducer >= producers || item.mSequence < next_sequence[item.mProducer]) {
+                        ordered.store(false);
+                    } else {
+                        next_sequence[item.mProducer] = item.mSequence + 1;
+                    }
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        std::vector< std::int64_t > all {};
+        all.reserve(total);
+        std::uint64_t sequence_sum = 0;
+        for (unsigned consumer = 0; consumer < consumers; ++consumer) {
+            all.insert(all.end(), latencies[consumer].begin(), latencies[consumer].end());
+            sequence_sum += sequence_sums[consumer];
+        }
+        std::sort(all.begin(), all.end());
+
+        const auto expected_sum = static_cast< std::uint64_t >(producers) * config.mItems * (config.mItems - 1) / 2;
+        const auto valid        = ordered.load() && all.size() == total && sequence_sum == expected_sum;
+
+        const auto finish  = *std::max_element(last_pop.begin(), last_pop.end());
+        const auto seconds = static_cast< double >(std::max< std::int64_t >(finish - start.load(), 1)) / 1e9;
+
+        char threads_used[32];
+        std::snprintf(threads_used, sizeof(threads_used), "%up/%uc", producers, consumers);
+        std::printf("%-10s %-4s %-7s %9llu items %9.3f Mitems/s   p50 %9.2fus   p99 %9.2fus   p99.9 %9.2fus%s\n",
+                    queue_name, topology.mName, threads_used, static_cast< unsigned long long >(total),
+                    static_cast< double >(total) / seconds / 1e6, Percentile_us(all, 0.5), Percentile_us(all, 0.99),
+                    Percentile_us(all, 0.999), valid ? "" : "   FAILED");
+        return valid;
+    }
+
+    template < class Queue >
+    bool Run_topologies(const char *queue_name, const std::vector< Topology > &topologies, const Config &config,
+                        const bool single_consumer_only = false, const bool single_producer_only = false) {
+        auto valid = true;
+        for (const auto &topology : topologies) {
+            if ((single_consumer_only && topology.mConsumers != 1) ||
+                (single_producer_only && topology.mProducers != 1)) {
+                continue;
+            }
+            valid = Run< Queue >(queue_name, topology, config) && valid;
+        }
+        return valid;
+    }
+
+    bool Parse(const int argc, char **argv, Config &config) {
+        for (auto arg = 1; arg < argc; ++arg) {
+            const std::string_view option { argv[arg] };
+            const auto             equals = option.find('=');
+            if (option.substr(0, 2) != "--" || equals == std::string_view::npos) {
+                return false;
+            }
+
+            const auto name  = option.substr(2, equals - 2);
+            const auto value = std::string { option.substr(equals + 1) };
+            if (name == "queue") {
+                config.mQueue = value;
+            } else if (name == "topology") {
+                config.mTopology = value;
+            } else if (name == "producers") {
+                config.mProducers = static_cast< unsigned >(std::max(std::stoul(value), 1UL));
+            } else if (name == "consumers") {
+                config.mConsumers = static_cast< unsigned >(std::max(std::stoul(value), 1UL));
+            } else if (name == "items") {
+                config.mItems = static_cast< std::uint32_t >(std::max(std::stoul(value), 1UL));
+            } else if (name == "rate") {
+                config.mRate = std::max(std::stod(value), 0.0);
+            } else if (name == "capacity") {
+                config.mCapacity = std::max< std::size_t >(std::stoull(value), 1);
+            } else if (name == "pin") {
+                config.mPin = value != "0";
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Config config {};
+    try {
+        if (!Parse(argc, argv, config)) {
+            std::fprintf(stderr, "usage: %s [--queue=concurrent|sharded|bounded|spsc|all] "
+                                 "[--topology=spsc|mpsc|mpmc|all] [--producers=N] [--consumers=N] [--items=N] "
+                                 "[--rate=N] [--capacity=N] [--pin=0|1]\n",
+                         argv[0]);
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception &) {
+        std::fprintf(stderr, "%s: option values must be numbers\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector< Topology > topologies {};
+    for (const auto &topology : { Topology { "spsc", 1, 1 }, Topology { "mpsc", config.mProducers, 1 },
+                                  Topology { "mpmc", config.mProducers, config.mConsumers } }) {
+        if (config.mTopology == "all" || config.mTopology == topology.mName) {
+            topologies.push_back(topology);
+        }
+    }
+
+    const auto wants = [&config](const char *queue) { return config.mQueue == "all" || config.mQueue == queue; };
+
+    auto valid = true;
+    if (wants("concurrent")) {
+        valid = Run_topologies< concurrent::concurrent_queue< Item > >("concurrent", topologies, config) && valid;
+    }
+    if (wants("sharded")) {
+        valid = Run_topologies< concurrent::sharded_concurrent_queue< Item > >("sharded", topologies, config) && valid;
+    }
+    if (wants("bounded")) {
+        valid = Run_topologies< concurrent::concurrent_bounded_queue< Item > >("bounded", topologies, config) && valid;
+    }
+    if (wants("spsc")) {
+        valid = Run_topologies< concurrent::spsc_queue< Item > >("spsc", topologies, config, true, true) && valid;
+    }
+    return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,169 @@
+#include <concurrent_queue.hpp>
+#include <concurrent_vector.hpp>
+#include <segment_pool.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <future>
+#include <memory_resource>
+#include <vector>
+
+// Upstream that counts how often the pool misses
+struct Counting_resource : std::pmr::memory_resource {
+    std::atomic< std::size_t > allocations   = 0;
+    std::atomic< std::size_t > deallocations = 0;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+template < class Type >
+using Queue = concurrent::concurrent_queue< Type, std::pmr::polymorphic_allocator< Type > >;
+
+template < class Type >
+using Vector = concurrent::concurrent_vector< Type, std::pmr::polymorphic_allocator< Type > >;
+
+void test_blocks_are_reused() {
+    Counting_resource        upstream {};
+    concurrent::segment_pool pool { &upstream };
+
+    auto first = pool.allocate(100);
+    pool.deallocate(first, 100);
+    assert(upstream.allocations == 1 && upstream.deallocations == 0);
+    assert(pool.retained_bytes() > 0);
+
+    // Same size class, served from the cache
+    auto second = pool.allocate(120);
+    assert(second == first && upstream.allocations == 1);
+    assert(pool.retained_bytes() == 0);
+
+    // Different size class
+    auto third = pool.allocate(1000);
+    assert(upstream.allocations == 2);
+
+    pool.deallocate(second, 120);
+    pool.deallocate(third, 1000);
+    assert(pool.retained_high_water_mark() == pool.retained_bytes());
+
+    pool.release();
+    assert(pool.retained_bytes() == 0 && upstream.deallocations == 2);
+}
+
+void test_retention_limit() {
+    Counting_resource        upstream {};
+    concurrent::segment_pool pool { &upstream };
+    pool.set_retention_limit(1024);
+
+    std::vector< void * > blocks {};
+    for (auto i = 0; i < 8; ++i) {
+        blocks.push_back(pool.allocate(256));
+    }
+    for (auto block : blocks) {
+        pool.deallocate(block, 256);
+    }
+
+    assert(pool.retained_bytes() == 1024);
+    assert(upstream.deallocations == 4);
+}
+
+void test_queue_churn_without_upstream() {
+    Counting_resource        upstream {};
+    concurrent::segment_pool pool { &upstream };
+
+    {
+        Queue< int > a { &pool };
+        int          v;
+        auto         churn = [&]() {
+            for (auto i = 0; i < 20000; ++i) {
+                a.push(i);
+                a.push(i);
+                a.try_pop(v);
+                a.try_pop(v);
+            }
+        };
+
+        churn(); // Warm up the pool
+        [[maybe_unused]] const auto warm_allocations = upstream.allocations.load();
+        churn();
+        assert(upstream.allocations == warm_allocations);
+        assert(a.empty());
+    }
+
+    pool.release();
+    assert(upstream.allocations == upstream.deallocations);
+}
+
+void test_queue_concurrent_on_pool() {
+    constexpr int producers  = 4;
+    constexpr int per_thread = 50000;
+
+    concurrent::segment_pool pool {};
+    Queue< int >             a { &pool };
+    std::atomic< long long > consumed_sum   = 0;
+    std::atomic_int          consumed_count = 0;
+
+    std::vector< std::future< void > > fn {};
+    for (auto p = 0; p < producers; ++p) {
+        fn.emplace_back(std::async(std::launch::async, [&, p]() {
+            for (auto i = 0; i < per_thread; ++i) {
+                a.push(p * per_thread + i);
+            }
+        }));
+        fn.emplace_back(std::async(std::launch::async, [&]() {
+            int v;
+            while (consumed_count < producers * per_thread) {
+                if (a.try_pop(v)) {
+                    consumed_sum += v;
+                    ++consumed_count;
+                }
+            }
+        }));
+    }
+    for (auto &f : fn) {
+        f.wait();
+    }
+
+    [[maybe_unused]] constexpr long long total = static_cast< long long >(producers) * per_thread;
+    assert(consumed_sum == total * (total - 1) / 2);
+}
+
+void test_vector_on_pool() {
+    Counting_resource        upstream {};
+    concurrent::segment_pool pool { &upstream };
+
+    for (auto round = 0; round < 3; ++round) {
+        Vector< int > a { &pool };
+        for (auto i = 0; i < 10000; ++i) {
+            a.push_back(i);
+        }
+        assert(a[9999] == 9999);
+    }
+
+    // Every round after the first reuses the segments of the previous one
+    [[maybe_unused]] const auto allocations = upstream.allocations.load();
+    {
+        Vector< int > a { &pool };
+        for (auto i = 0; i < 10000; ++i) {
+            a.push_back(i);
+        }
+    }
+    assert(upstream.allocations == allocations);
+}
+
+int main() {
+    test_blocks_are_reused();
+    test_retention_limit();
+    test_queue_churn_without_upstream();
+    for (auto i = 0; i < 5; ++i) {
+        test_queue_concurrent_on_pool();
+    }
+    test_vector_on_pool();
+}
@@ -0,0 +1,193 @@
+#include <sharded_concurrent_queue.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Every thread picks its shard by hand, so the tests do not depend on the machine's topology
+thread_local std::size_t tShard = 0;
+
+struct Pinned_shards {
+    std::size_t mCount;
+
+    [[nodiscard]] std::size_t shard_count() const noexcept { return mCount; }
+    [[nodiscard]] std::size_t current_shard() const noexcept { return tShard; }
+};
+
+using pinned_queue = concurrent::sharded_concurrent_queue< int, Pinned_shards >;
+
+// Remembers the shard it was made for
+template < class Type >
+struct Shard_allocator : std::allocator< Type > {
+    template < class Other >
+    struct rebind {
+        using other = Shard_allocator< Other >;
+    };
+
+    Shard_allocator(std::size_t shard = 0) noexcept : mShard(shard) {}
+    template < class Other >
+    Shard_allocator(const Shard_allocator< Other > &rhs) noexcept : mShard(rhs.mShard) {}
+
+    std::size_t mShard;
+};
+
+void test_shard_is_fifo() {
+    pinned_queue queue { Pinned_shards { 3 } };
+    assert(queue.shard_count() == 3 && queue.empty());
+
+    tShard = 4;
+    assert(queue.current_shard() == 1);
+    for (auto i = 0; i < 1000; ++i) {
+        queue.push(i);
+    }
+    assert(queue.shard(1).size_hint() == 1000 && queue.size_hint() == 1000);
+
+    auto value = -1;
+    for (auto i = 0; i < 1000; ++i) {
+        [[maybe_unused]] const auto popped = queue.try_pop(value);
+        assert(popped && value == i);
+    }
+    [[maybe_unused]] const auto popped = queue.try_pop(value);
+    assert(!popped && value == 0 && queue.empty());
+}
+
+void test_local_shard_first_then_steal() {
+    pinned_queue queue { Pinned_shards { 3 } };
+    queue.shard(2).push(20);
+    queue.shard(2).push(21);
+    queue.shard(0).push(0);
+    queue.shard(1).push(10);
+
+    // Shard 1 drains itself, then rotates on to 2 and wraps around to 0
+    tShard = 1;
+    for ([[maybe_unused]] const auto expected : { 10, 20, 21, 0 }) {
+        [[maybe_unused]] const auto popped = queue.try_pop();
+        assert(popped == expected);
+    }
+    [[maybe_unused]] const auto drained = !queue.try_pop();
+    assert(drained);
+
+    const int range[] = { 1, 2, 3, 4, 5 };
+    tShard            = 2;
+    queue.push_range(std::begin(range), std::end(range));
+    queue.shard(0).push(6);
+    assert(queue.shard(2).size_hint() == 5);
+
+    tShard = 0;
+    std::vector< int > popped {};
+    [[maybe_unused]] const auto first_bulk = queue.try_pop_bulk(std::back_inserter(popped), 4);
+    assert(first_bulk == 4 && (popped == std::vector< int > { 6, 1, 2, 3 }));
+    [[maybe_unused]] const auto second_bulk = queue.try_pop_bulk(std::back_inserter(popped), 10);
+    assert(second_bulk == 2 && popped.back() == 5);
+
+    // Plain pointers and array iterators have to move on from one shard to the next as well
+    queue.shard(0).push(8);
+    queue.shard(1).push(9);
+    queue.shard(2).push(10);
+    std::array< int, 4 >        fixed {};
+    [[maybe_unused]] const auto fixed_bulk = queue.try_pop_bulk(fixed.begin(), fixed.size());
+    assert(fixed_bulk == 3 && fixed[0] == 8 && fixed[1] == 9 && fixed[2] == 10 && fixed[3] == 0);
+
+    queue.shard(1).push(11);
+    queue.shard(2).push(12);
+    int                         raw[2] {};
+    [[maybe_unused]] const auto raw_bulk = queue.try_pop_bulk(raw, 2);
+    assert(raw_bulk == 2 && raw[0] == 11 && raw[1] == 12);
+
+    queue.push(7);
+    queue.clear();
+    assert(queue.empty());
+}
+
+void test_allocator_per_shard() {
+    using queue_type = concurrent::sharded_concurrent_queue< int, Pinned_shards, Shard_allocator< int > >;
+    queue_type queue { Pinned_shards { 4 }, [](std::size_t shard) { return Shard_allocator< int > { shard }; } };
+    for (std::size_t shard = 0; shard < queue.shard_count(); ++shard) {
+        assert(queue.shard(shard).get_allocator().mShard == shard);
+    }
+
+    queue_type shared { Pinned_shards { 2 }, Shard_allocator< int > { 9 } };
+    assert(shared.shard(0).get_allocator().mShard == 9 && shared.shard(1).get_allocator().mShard == 9);
+}
+
+void test_topology_selectors() {
+    concurrent::sharded_concurrent_queue< int > by_node {};
+    assert(by_node.shard_count() >= 1 && by_node.current_shard() < by_node.shard_count());
+    by_node.push(1);
+    auto                        value     = 0;
+    [[maybe_unused]] const auto from_node = by_node.try_pop(value);
+    assert(from_node && value == 1);
+
+    [[maybe_unused]] const auto cores = std::max(std::thread::hardware_concurrency(), 1U);
+    concurrent::sharded_concurrent_queue< int, concurrent::core_group_shards > by_core {
+        concurrent::core_group_shards { 2 }
+    };
+    assert(by_core.shard_count() == (cores + 1) / 2 && by_core.current_shard() < by_core.shard_count());
+    by_core.push(2);
+    [[maybe_unused]] const auto from_core = by_core.try_pop(value);
+    assert(from_core && value == 2);
+}
+
+// Each producer sits on one shard, so the elements of a producer must leave in its push order
+void test_concurrent_producers_and_consumers() {
+    constexpr auto producers    = 4;
+    constexpr auto consumers    = 4;
+    constexpr auto per_producer = 20000;
+
+    pinned_queue               queue { Pinned_shards { 2 } };
+    std::atomic< int >         done_producers { 0 };
+    std::atomic< long long >   sum { 0 };
+    std::atomic< int >         count { 0 };
+    std::vector< std::thread > threads {};
+
+    for (auto producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&, producer] {
+            tShard = static_cast< std::size_t >(producer);
+            for (auto i = 0; i < per_producer; ++i) {
+                queue.push(producer * per_producer + i);
+            }
+            done_producers.fetch_add(1);
+        });
+    }
+    for (auto consumer = 0; consumer < consumers; ++consumer) {
+        threads.emplace_back([&, consumer] {
+            tShard = static_cast< std::size_t >(consumer);
+            std::vector< int > last(producers, -1);
+            auto               value = 0;
+            for (;;) {
+                const auto finished = done_producers.load() == producers;
+                if (queue.try_pop(value)) {
+                    const auto producer = value / per_producer;
+                    assert(value > last[producer]);
+                    last[producer] = value;
+                    sum.fetch_add(value);
+                    count.fetch_add(1);
+                } else if (finished) {
+                    break;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    [[maybe_unused]] constexpr auto total = producers * per_producer;
+    assert(count.load() == total && sum.load() == static_cast< long long >(total - 1) * total / 2);
+    assert(queue.empty());
+}
+
+int main() {
+    test_shard_is_fifo();
+    test_local_shard_first_then_steal();
+    test_allocator_per_shard();
+    test_topology_selectors();
+    for (auto i = 0; i < 3; ++i) {
+        test_concurrent_producers_and_consumers();
+    }
+}
@@ -0,0 +1,77 @@
+#include <spsc_queue.hpp>
+
+#include <cassert>
+#include <future>
+#include <memory>
+#include <string>
+
+template < class Type >
+using T = concurrent::spsc_queue< Type >;
+
+void test_push_try_pop() {
+    T< std::string >            a {};
+    std::string                 v;
+    [[maybe_unused]] const auto popped_empty = a.try_pop(v);
+    assert(a.empty() && !popped_empty);
+
+    // Spans several segments
+    for (auto i = 0; i < 5000; ++i) {
+        a.push(std::to_string(i));
+    }
+    for (auto i = 0; i < 5000; ++i) {
+        [[maybe_unused]] const auto popped = a.try_pop(v);
+        assert(popped && v == std::to_string(i));
+    }
+    [[maybe_unused]] const auto drained = !a.try_pop(v);
+    assert(a.empty() && drained);
+
+    a.emplace(3, 'x');
+    [[maybe_unused]] const auto emplaced = a.try_pop(v);
+    assert(emplaced && v == "xxx");
+}
+
+void test_move_only_and_clear() {
+    T< std::unique_ptr< int > > a {};
+    for (auto i = 0; i < 3000; ++i) {
+        a.push(std::make_unique< int >(i));
+    }
+
+    std::unique_ptr< int >      v;
+    [[maybe_unused]] const auto popped = a.try_pop(v);
+    assert(popped && *v == 0);
+
+    a.clear();
+    assert(a.empty());
+
+    // Leftovers are released by the destructor
+    a.push(std::make_unique< int >(1));
+}
+
+void test_producer_consumer() {
+    constexpr int count = 1000000;
+
+    T< int > a {};
+    auto     producer = std::async(std::launch::async, [&a]() {
+        for (auto i = 0; i < count; ++i) {
+            a.push(i);
+        }
+    });
+
+    int v;
+    for (auto expected = 0; expected < count;) {
+        if (a.try_pop(v)) {
+            assert(v == expected);
+            ++expected;
+        }
+    }
+    producer.wait();
+    assert(a.empty());
+}
+
+int main() {
+    test_push_try_pop();
+    test_move_only_and_clear();
+    for (auto i = 0; i < 5; ++i) {
+        test_producer_consumer();
+    }
+}